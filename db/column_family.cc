@@ -534,7 +534,7 @@ ColumnFamilyData::ColumnFamilyData(
           cf_options.table_factory->IsDeleteRangeSupported()),
       write_buffer_manager_(write_buffer_manager),
       mem_(nullptr),
-      imm_(ioptions_.min_write_buffer_number_to_merge,
+      imm_(mutable_cf_options_.min_write_buffer_number_to_merge,
            ioptions_.max_write_buffer_number_to_maintain,
            ioptions_.max_write_buffer_size_to_maintain),
       super_version_(nullptr),
@@ -870,8 +870,7 @@ std::pair<WriteStallCondition, ColumnFamilyData::WriteStallCause>
 ColumnFamilyData::GetWriteStallConditionAndCause(
     int num_unflushed_memtables, int num_l0_files,
     uint64_t num_compaction_needed_bytes,
-    const MutableCFOptions& mutable_cf_options,
-    const ImmutableCFOptions& immutable_cf_options) {
+    const MutableCFOptions& mutable_cf_options) {
   if (num_unflushed_memtables >= mutable_cf_options.max_write_buffer_number) {
     return {WriteStallCondition::kStopped, WriteStallCause::kMemtableLimit};
   } else if (!mutable_cf_options.disable_auto_compactions &&
@@ -887,7 +886,7 @@ ColumnFamilyData::GetWriteStallConditionAndCause(
              num_unflushed_memtables >=
                  mutable_cf_options.max_write_buffer_number - 1 &&
              num_unflushed_memtables - 1 >=
-                 immutable_cf_options.min_write_buffer_number_to_merge) {
+                 mutable_cf_options.min_write_buffer_number_to_merge) {
     return {WriteStallCondition::kDelayed, WriteStallCause::kMemtableLimit};
   } else if (!mutable_cf_options.disable_auto_compactions &&
              mutable_cf_options.level0_slowdown_writes_trigger >= 0 &&
@@ -907,6 +906,14 @@ ColumnFamilyData::GetWriteStallConditionAndCause(
 WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       const MutableCFOptions& mutable_cf_options) {
   auto write_stall_condition = WriteStallCondition::kNormal;
+  if (ioptions_.tuning_trigger != nullptr) {
+    // wake the tuner one memtable before the memtable limit starts delaying
+    // (or, without a delay step, stopping) writes
+    const int max_memtables = mutable_cf_options.max_write_buffer_number;
+    imm_.SetTuningTrigger(
+        ioptions_.tuning_trigger,
+        std::max(1, max_memtables > 3 ? max_memtables - 2 : max_memtables - 1));
+  }
   if (current_ != nullptr) {
     auto* vstorage = current_->storage_info();
     auto write_controller = column_family_set_->write_controller_;
@@ -915,8 +922,7 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
 
     auto write_stall_condition_and_cause = GetWriteStallConditionAndCause(
         imm()->NumNotFlushed(), vstorage->l0_delay_trigger_count(),
-        vstorage->estimated_compaction_needed_bytes(), mutable_cf_options,
-        *ioptions());
+        vstorage->estimated_compaction_needed_bytes(), mutable_cf_options);
     write_stall_condition = write_stall_condition_and_cause.first;
     auto write_stall_cause = write_stall_condition_and_cause.second;
 
@@ -1440,8 +1446,14 @@ Status ColumnFamilyData::SetOptions(
     s = ValidateOptions(db_opts, cf_opts);
   }
   if (s.ok()) {
+    // sanitized like at open
+    cf_opts.min_write_buffer_number_to_merge =
+        std::max(1, std::min(cf_opts.min_write_buffer_number_to_merge,
+                             cf_opts.max_write_buffer_number - 1));
     mutable_cf_options_ = MutableCFOptions(cf_opts);
     mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+    imm_.SetMinWriteBufferNumberToMerge(
+        mutable_cf_options_.min_write_buffer_number_to_merge);
   }
   return s;
 }
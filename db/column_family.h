@@ -477,8 +477,7 @@ class ColumnFamilyData {
   GetWriteStallConditionAndCause(
       int num_unflushed_memtables, int num_l0_files,
       uint64_t num_compaction_needed_bytes,
-      const MutableCFOptions& mutable_cf_options,
-      const ImmutableCFOptions& immutable_cf_options);
+      const MutableCFOptions& mutable_cf_options);
 
   // Recalculate some stall conditions, which are changed only during
   // compaction, adding new memtable and/or recalculation of compaction score.
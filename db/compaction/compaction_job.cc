@@ -866,6 +866,8 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   }
 
   UpdateCompactionJobStats(stats);
+  RecordQuicksandMetrics(stats, vstorage, write_amp, bytes_read_per_sec,
+                         bytes_written_per_sec);
 
   auto stream = event_logger_->LogToBuffer(log_buffer_, 8192);
   stream << "job" << job_id_ << "event"
@@ -1932,6 +1934,53 @@ void CompactionJob::UpdateCompactionJobStats(
 #endif  // !ROCKSDB_LITE
 }
 
+void CompactionJob::RecordQuicksandMetrics(
+    const InternalStats::CompactionStats& stats,
+    const VersionStorageInfo* vstorage, double write_amp,
+    double bytes_read_per_sec, double bytes_written_per_sec) {
+  db_mutex_->AssertHeld();
+  if (db_options_.job_stats == nullptr) {
+    return;
+  }
+  Compaction* compaction = compact_->compaction;
+  ColumnFamilyData* cfd = compaction->column_family_data();
+
+  // One record per finished compaction. compaction_stats_ has already been
+  // aggregated across all subcompactions in Run().
+  QuicksandMetrics metrics;
+  metrics.input_level = compaction->start_level();
+  metrics.output_level = compaction->output_level();
+  metrics.drop_ratio =
+      stats.num_input_records == 0
+          ? 0.0
+          : static_cast<double>(stats.num_dropped_records) /
+                stats.num_input_records;
+  // bytes per micro, which is the same unit as FlushMetrics (MB/s)
+  metrics.read_in_bandwidth = bytes_read_per_sec;
+  metrics.write_out_bandwidth = bytes_written_per_sec;
+  metrics.max_bg_compaction =
+      mutable_db_options_copy_.max_background_compactions;
+  metrics.max_bg_flush = mutable_db_options_copy_.max_background_flushes;
+  metrics.cpu_time_ratio =
+      stats.micros == 0
+          ? 0.0
+          : static_cast<double>(stats.cpu_micros) / stats.micros;
+  metrics.total_micros = static_cast<double>(stats.micros);
+  metrics.write_amplification = write_amp;
+  metrics.total_bytes = stats.bytes_read_non_output_levels +
+                        stats.bytes_read_output_level + stats.bytes_read_blob +
+                        stats.bytes_written + stats.bytes_written_blob;
+  metrics.current_pending_bytes = vstorage->estimated_compaction_needed_bytes();
+  metrics.immu_num = cfd->imm() == nullptr ? 0 : cfd->imm()->NumNotFlushed();
+  metrics.io_stat.prepare_latency =
+      compaction_job_stats_->file_prepare_write_nanos;
+  metrics.io_stat.fsync_latency = compaction_job_stats_->file_fsync_nanos;
+  metrics.io_stat.range_latency = compaction_job_stats_->file_range_sync_nanos;
+  metrics.io_stat.file_write_latency = compaction_job_stats_->file_write_nanos;
+
+  db_options_.job_stats->Push(metrics);
+}
+
 void CompactionJob::LogCompaction() {
   Compaction* compaction = compact_->compaction;
   ColumnFamilyData* cfd = compaction->column_family_data();
@@ -262,6 +262,13 @@ class CompactionJob {
                                   CompactionOutputs& outputs);
   void UpdateCompactionJobStats(
     const InternalStats::CompactionStats& stats) const;
+  // Append one QuicksandMetrics record for this compaction to
+  // ImmutableDBOptions::job_stats so that the DOTA tuners can score the
+  // compaction side of the system. REQUIRED: mutex held
+  void RecordQuicksandMetrics(const InternalStats::CompactionStats& stats,
+                              const VersionStorageInfo* vstorage,
+                              double write_amp, double bytes_read_per_sec,
+                              double bytes_written_per_sec);
   void RecordDroppedKeys(const CompactionIterationStats& c_iter_stats,
                          CompactionJobStats* compaction_job_stats = nullptr);
 
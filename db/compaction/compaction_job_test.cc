@@ -357,6 +357,7 @@ class CompactionJobTestBase : public testing::Test {
     }
 
     uint64_t file_number = versions_->NewFileNumber();
+    const uint64_t num_entries = contents.size();
 
     uint64_t file_size;
     if (test_io_priority_) {
@@ -367,12 +368,18 @@ class CompactionJobTestBase : public testing::Test {
           env_, GenerateFileName(file_number), std::move(contents)));
     }
 
+    FileMetaData meta(file_number, 0, file_size, smallest_key, largest_key,
+                      smallest_seqno, largest_seqno, false,
+                      Temperature::kUnknown, oldest_blob_file_number,
+                      kUnknownOldestAncesterTime, kUnknownFileCreationTime,
+                      kUnknownFileChecksum, kUnknownFileChecksumFuncName,
+                      kNullUniqueId64x2);
+    // as the table properties of a real file would tell, the mock tables
+    // have none to load them from
+    meta.num_entries = num_entries;
+    meta.init_stats_from_file = true;
     VersionEdit edit;
-    edit.AddFile(level, file_number, 0, file_size, smallest_key, largest_key,
-                 smallest_seqno, largest_seqno, false, Temperature::kUnknown,
-                 oldest_blob_file_number, kUnknownOldestAncesterTime,
-                 kUnknownFileCreationTime, kUnknownFileChecksum,
-                 kUnknownFileChecksumFuncName, kNullUniqueId64x2);
+    edit.AddFile(level, meta);
 
     mutex_.Lock();
     EXPECT_OK(
@@ -727,6 +734,44 @@ TEST_F(CompactionJobTest, SimpleOverwrite) {
   RunCompaction({files}, expected_results);
 }
 
+TEST_F(CompactionJobTest, RecordQuicksandMetrics) {
+  NewDB();
+
+  auto file1 = mock::MakeMockFile({
+      {KeyStr("a", 3U, kTypeValue), "val2"},
+      {KeyStr("b", 4U, kTypeValue), "val3"},
+  });
+  AddMockFile(file1);
+
+  auto file2 = mock::MakeMockFile({{KeyStr("a", 1U, kTypeValue), "val"},
+                                   {KeyStr("b", 2U, kTypeValue), "val"}});
+  AddMockFile(file2);
+
+  auto expected_results =
+      mock::MakeMockFile({{KeyStr("a", 0U, kTypeValue), "val2"},
+                          {KeyStr("b", 0U, kTypeValue), "val3"}});
+
+  SetLastSequence(4U);
+  ASSERT_NE(db_options_.job_stats, nullptr);
+  ASSERT_EQ(db_options_.job_stats->Head(), 0U);
+  auto files = cfd_->current()->storage_info()->LevelFiles(0);
+  RunCompaction({files}, expected_results);
+
+  uint64_t cursor = 0;
+  std::vector<QuicksandMetrics> records;
+  ASSERT_EQ(db_options_.job_stats->ReadSince(&cursor, &records), 0U);
+  ASSERT_EQ(cursor, 1U);
+  ASSERT_EQ(records.size(), 1U);
+  const QuicksandMetrics& metrics = records.back();
+  ASSERT_EQ(metrics.input_level, 0);
+  ASSERT_EQ(metrics.output_level, 1);
+  // two of the four input records are overwritten
+  ASSERT_DOUBLE_EQ(metrics.drop_ratio, 0.5);
+  ASSERT_GT(metrics.total_bytes, 0U);
+  ASSERT_EQ(metrics.max_bg_compaction,
+            mutable_db_options_.max_background_compactions);
+}
+
 TEST_F(CompactionJobTest, SimpleNonLastLevel) {
   NewDB();
 
@@ -97,6 +97,10 @@ class LevelCompactionBuilder {
   // Return true if a L0 trivial move is picked up.
   bool TryPickL0TrivialMove();
 
+  // Return true if max_compactions_per_output_level caps the compactions into
+  // `output_level` and as many of them are running already.
+  bool OutputLevelFull(int output_level) const;
+
   // For L0->L0, picks the longest span of files that aren't currently
   // undergoing compaction for which work-per-deleted-file decreases. The span
   // always starts from the newest L0 file.
@@ -170,6 +174,9 @@ void LevelCompactionBuilder::PickFileToCompact(
     } else {
       output_level_ = start_level_;
     }
+    if (OutputLevelFull(output_level_)) {
+      continue;
+    }
     start_level_inputs_.files = {level_file.second};
     start_level_inputs_.level = start_level_;
     if (compaction_picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
@@ -196,7 +203,7 @@ void LevelCompactionBuilder::SetupInitialFiles() {
       }
       output_level_ =
           (start_level_ == 0) ? vstorage_->base_level() : start_level_ + 1;
-      if (PickFileToCompact()) {
+      if (!OutputLevelFull(output_level_) && PickFileToCompact()) {
         // found the compaction!
         if (start_level_ == 0) {
           // L0 score = `num L0 files` / `level0_file_num_compaction_trigger`
@@ -218,7 +225,7 @@ void LevelCompactionBuilder::SetupInitialFiles() {
           // In these cases, to reduce L0 file count and thus reduce likelihood
           // of write stalls, we can attempt compacting a span of files within
           // L0.
-          if (PickIntraL0Compaction()) {
+          if (!OutputLevelFull(0) && PickIntraL0Compaction()) {
             output_level_ = 0;
             compaction_reason_ = CompactionReason::kLevelL0FilesNum;
             break;
@@ -780,6 +787,21 @@ bool LevelCompactionBuilder::PickFileToCompact() {
   return start_level_inputs_.size() > 0;
 }
 
+bool LevelCompactionBuilder::OutputLevelFull(int output_level) const {
+  const int limit =
+      mutable_cf_options_.MaxCompactionsForOutputLevel(output_level);
+  if (limit <= 0) {
+    return false;
+  }
+  int running = 0;
+  for (const Compaction* c : *compaction_picker_->compactions_in_progress()) {
+    if (c->output_level() == output_level) {
+      running++;
+    }
+  }
+  return running >= limit;
+}
+
 bool LevelCompactionBuilder::PickIntraL0Compaction() {
   start_level_inputs_.clear();
   const std::vector<FileMetaData*>& level_files =
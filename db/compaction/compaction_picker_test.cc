@@ -263,6 +263,41 @@ TEST_F(CompactionPickerTest, LevelMaxScore) {
             compaction->OutputFilePreallocationSize());
 }
 
+TEST_F(CompactionPickerTest, LevelMaxCompactionsPerOutputLevel) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  mutable_cf_options_.max_bytes_for_level_base = 10 * 1024 * 1024;
+  mutable_cf_options_.max_compactions_per_output_level = {0, 0, 1};
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+  // Level 1 score 2.4, every file can move to level 2 on its own
+  Add(1, 1U, "100", "150", 8000000U);
+  Add(1, 2U, "300", "350", 8000000U);
+  Add(1, 3U, "500", "550", 8000000U);
+  Add(2, 4U, "160", "290", 1000000U);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction);
+  ASSERT_EQ(2, compaction->output_level());
+
+  // the compaction above takes the only slot into level 2
+  vstorage_->ComputeCompactionScore(ioptions_, mutable_cf_options_);
+  std::unique_ptr<Compaction> compaction2(
+      level_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+          &log_buffer_));
+  ASSERT_FALSE(compaction2);
+
+  mutable_cf_options_.max_compactions_per_output_level = {0, 0, 2};
+  std::unique_ptr<Compaction> compaction3(
+      level_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+          &log_buffer_));
+  ASSERT_TRUE(compaction3);
+  ASSERT_EQ(2, compaction3->output_level());
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionLevel) {
   const int kLevels = 6;
   const int kFileCount = 20;
@@ -106,6 +106,7 @@
 #include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
+#include "utilities/DOTA/auto_tuner.h"
 #include "utilities/trace/replayer_impl.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -270,8 +271,12 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   periodic_task_functions_.emplace(
       PeriodicTaskType::kRecordSeqnoTime,
       [this]() { this->RecordSeqnoToTimeMapping(); });
+  periodic_task_functions_.emplace(PeriodicTaskType::kAutoTune,
+                                   [this]() { this->AutoTune(); });
 #endif  // ROCKSDB_LITE
 
+  write_controller_.SetTuningTrigger(immutable_db_options_.tuning_trigger);
+
   versions_.reset(new VersionSet(dbname_, &immutable_db_options_, file_options_,
                                  table_cache_.get(), write_buffer_manager_,
                                  &write_controller_, &block_cache_tracer_,
@@ -502,6 +507,8 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
                      task_type, s.ToString().c_str());
     }
   }
+  // the task is gone, so nothing can tick the tuner any more
+  auto_tuner_.reset();
 #endif  // !ROCKSDB_LITE
 
   InstrumentedMutexLock l(&mutex_);
@@ -824,6 +831,20 @@ Status DBImpl::StartPeriodicTaskScheduler() {
     }
   }
 
+  if (immutable_db_options_.tuning_policy != nullptr &&
+      immutable_db_options_.auto_tune_period_sec > 0) {
+    auto_tuner_.reset(new AutoTuner(this, immutable_db_options_.tuning_policy,
+                                    immutable_db_options_.auto_tune_period_sec,
+                                    immutable_db_options_.auto_tune_gap_sec));
+    Status s = periodic_task_scheduler_.Register(
+        PeriodicTaskType::kAutoTune,
+        periodic_task_functions_.at(PeriodicTaskType::kAutoTune),
+        immutable_db_options_.auto_tune_period_sec);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
   Status s = periodic_task_scheduler_.Register(
       PeriodicTaskType::kFlushInfoLog,
       periodic_task_functions_.at(PeriodicTaskType::kFlushInfoLog));
@@ -1121,6 +1142,16 @@ void DBImpl::FlushInfoLog() {
   LogFlush(immutable_db_options_.info_log);
 }
 
+void DBImpl::AutoTune() {
+#ifndef ROCKSDB_LITE
+  if (shutdown_initiated_ || auto_tuner_ == nullptr) {
+    return;
+  }
+  TEST_SYNC_POINT("DBImpl::AutoTune:StartRunning");
+  auto_tuner_->Tick();
+#endif  // !ROCKSDB_LITE
+}
+
 Status DBImpl::TablesRangeTombstoneSummary(ColumnFamilyHandle* column_family,
                                            int max_entries_to_print,
                                            std::string* out_str) {
@@ -1187,6 +1218,14 @@ Status DBImpl::SetOptions(
       VersionEdit dummy_edit;
       s = versions_->LogAndApply(cfd, new_options, &dummy_edit, &mutex_,
                                  directories_.GetDbDir());
+      // A narrower min_write_buffer_number_to_merge may leave enough
+      // immutable memtables for a flush.
+      if (!immutable_db_options_.atomic_flush &&
+          cfd->imm()->IsFlushPending()) {
+        FlushRequest flush_req;
+        GenerateFlushRequest({cfd}, &flush_req);
+        SchedulePendingFlush(flush_req, FlushReason::kWriteBufferFull);
+      }
       // Trigger possible flush/compactions. This has to be before we persist
       // options to file, otherwise there will be a deadlock with writer
       // thread.
@@ -1305,6 +1344,21 @@ Status DBImpl::SetDBOptions(
         MaybeScheduleFlushOrCompaction();
       }
 
+      if (immutable_db_options_.shrink_background_threads) {
+        // Retire the pool threads created for an earlier, higher limit. The
+        // pool lets each excess thread finish its current job first, so
+        // running flushes and compactions are not interrupted.
+        if (new_bg_job_limits.max_flushes < current_bg_job_limits.max_flushes) {
+          env_->SetBackgroundThreads(new_bg_job_limits.max_flushes,
+                                     Env::Priority::HIGH);
+        }
+        if (new_bg_job_limits.max_compactions <
+            current_bg_job_limits.max_compactions) {
+          env_->SetBackgroundThreads(new_bg_job_limits.max_compactions,
+                                     Env::Priority::LOW);
+        }
+      }
+
       mutex_.Unlock();
       if (new_options.stats_dump_period_sec == 0) {
         s = periodic_task_scheduler_.Unregister(PeriodicTaskType::kDumpStats);
@@ -1347,6 +1401,7 @@ Status DBImpl::SetDBOptions(
       file_options_for_compaction_ = fs_->OptimizeForCompactionTableWrite(
           file_options_for_compaction_, immutable_db_options_);
       versions_->ChangeFileOptions(mutable_db_options_);
+      PublishTuningSnapshot();
       //TODO(xiez): clarify why apply optimize for read to write options
       file_options_for_compaction_ = fs_->OptimizeForCompactionTableRead(
           file_options_for_compaction_, immutable_db_options_);
@@ -1952,6 +2007,9 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
 
   PERF_CPU_TIMER_GUARD(get_cpu_nanos, immutable_db_options_.clock);
   StopWatch sw(immutable_db_options_.clock, stats_, DB_GET);
+  TuningLatencyTimer tuning_sw(immutable_db_options_.clock,
+                               immutable_db_options_.tuning_latency.get(),
+                               TuningLatency::kRead);
   PERF_TIMER_GUARD(get_snapshot_time);
 
   auto cfh = static_cast_with_check<ColumnFamilyHandleImpl>(
@@ -3933,6 +3991,67 @@ bool DBImpl::GetAggregatedIntProperty(const Slice& property,
   return ret;
 }
 
+Status DBImpl::GetTuningSnapshot(TuningSnapshot* snapshot) {
+  assert(snapshot != nullptr);
+  tuning_snapshot_.Read(default_cf_internal_stats_->GetDBStats(
+                            InternalStats::kIntStatsBytesWritten),
+                        snapshot);
+  return Status::OK();
+}
+
+void DBImpl::PublishTuningSnapshot() {
+  mutex_.AssertHeld();
+  TuningSnapshot snapshot;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    const uint64_t active = cfd->mem()->ApproximateMemoryUsageFast();
+    snapshot.active_memtable_bytes += active;
+    snapshot.memtable_bytes += active + cfd->imm()->ApproximateMemoryUsage();
+    snapshot.immutable_memtables += cfd->imm()->NumNotFlushed();
+
+    const auto* vstorage = cfd->current()->storage_info();
+    const int num_levels = vstorage->num_levels();
+    snapshot.num_levels = std::max(
+        snapshot.num_levels, std::min(num_levels, TuningSnapshot::kMaxLevels));
+    for (int level = 0; level < num_levels; level++) {
+      const int slot = std::min(level, TuningSnapshot::kMaxLevels - 1);
+      snapshot.level_files[slot] += vstorage->NumLevelFiles(level);
+      snapshot.level_bytes[slot] += vstorage->NumLevelBytes(level);
+    }
+    snapshot.pending_compaction_bytes +=
+        vstorage->estimated_compaction_needed_bytes();
+  }
+
+  snapshot.write_stopped = write_controller_.IsStopped();
+  snapshot.write_delayed = write_controller_.NeedsDelay();
+  snapshot.delayed_write_rate = write_controller_.delayed_write_rate();
+
+  // the limits once compactions are parallelized, not the throttled ones
+  const BGJobLimits limits =
+      GetBGJobLimits(mutable_db_options_.max_background_flushes,
+                     mutable_db_options_.max_background_compactions,
+                     mutable_db_options_.max_background_jobs,
+                     true /* parallelize_compactions */);
+  snapshot.max_background_jobs = mutable_db_options_.max_background_jobs;
+  snapshot.max_background_flushes = limits.max_flushes;
+  snapshot.max_background_compactions = limits.max_compactions;
+  // also published while recovering, before default_cf_handle_ exists
+  ColumnFamilyData* default_cfd = versions_->GetColumnFamilySet()->GetDefault();
+  if (default_cfd == nullptr) {
+    return;
+  }
+  const MutableCFOptions* default_cf_options =
+      default_cfd->GetLatestMutableCFOptions();
+  snapshot.write_buffer_size = default_cf_options->write_buffer_size;
+  snapshot.target_file_size_base = default_cf_options->target_file_size_base;
+
+  tuning_snapshot_.Publish(snapshot,
+                           default_cfd->internal_stats()->GetDBStats(
+                               InternalStats::kIntStatsBytesWritten));
+}
+
 SuperVersion* DBImpl::GetAndRefSuperVersion(ColumnFamilyData* cfd) {
   // TODO(ljin): consider using GetReferencedSuperVersion() directly
   return cfd->GetThreadLocalSuperVersion(this);
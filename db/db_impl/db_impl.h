@@ -41,6 +41,7 @@
 #include "db/snapshot_checker.h"
 #include "db/snapshot_impl.h"
 #include "db/trim_history_scheduler.h"
+#include "db/tuning_snapshot_publisher.h"
 #include "db/version_edit.h"
 #include "db/wal_manager.h"
 #include "db/write_controller.h"
@@ -73,6 +74,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Arena;
 class ArenaWrappedDBIter;
+class AutoTuner;
 class InMemoryStatsHistoryIterator;
 class MemTable;
 class PersistentStatsHistoryIterator;
@@ -361,6 +363,7 @@ class DBImpl : public DB {
   using DB::GetAggregatedIntProperty;
   virtual bool GetAggregatedIntProperty(const Slice& property,
                                         uint64_t* aggregated_value) override;
+  virtual Status GetTuningSnapshot(TuningSnapshot* snapshot) override;
   using DB::GetApproximateSizes;
   virtual Status GetApproximateSizes(const SizeApproximationOptions& options,
                                      ColumnFamilyHandle* column_family,
@@ -1160,6 +1163,8 @@ class DBImpl : public DB {
 
 #ifndef ROCKSDB_LITE
   const PeriodicTaskScheduler& TEST_GetPeriodicTaskScheduler() const;
+
+  AutoTuner* TEST_GetAutoTuner() const { return auto_tuner_.get(); }
 #endif  // !ROCKSDB_LITE
 
 #endif  // NDEBUG
@@ -1176,6 +1181,9 @@ class DBImpl : public DB {
   // record current sequence number to time mapping
   void RecordSeqnoToTimeMapping();
 
+  // run one tick of the tuning_policy, see AutoTuner
+  void AutoTune();
+
   // Interface to block and signal the DB in case of stalling writes by
   // WriteBufferManager. Each DBImpl object contains ptr to WBMStallInterface.
   // When DB needs to be blocked or signalled by WriteBufferManager,
@@ -2136,6 +2144,10 @@ class DBImpl : public DB {
       ColumnFamilyData* cfd, SuperVersionContext* sv_context,
       const MutableCFOptions& mutable_cf_options);
 
+  // Publishes the state read by GetTuningSnapshot().
+  // REQUIRES: mutex locked
+  void PublishTuningSnapshot();
+
   bool GetIntPropertyInternal(ColumnFamilyData* cfd,
                               const DBPropertyInfo& property_info,
                               bool is_locked, uint64_t* value);
@@ -2444,6 +2456,9 @@ class DBImpl : public DB {
 
   WriteController write_controller_;
 
+  // The last state published for option tuners
+  TuningSnapshotPublisher tuning_snapshot_;
+
   // Size of the last batch group. In slowdown mode, next write needs to
   // sleep if it uses up the quota.
   // Note: This is to protect memtable and compaction. If the batch only writes
@@ -2613,6 +2628,11 @@ class DBImpl : public DB {
 
   // It contains the implementations for each periodic task.
   std::map<PeriodicTaskType, const PeriodicTaskFunc> periodic_task_functions_;
+
+  // Runs tuning_policy inside the DB when auto_tune_period_sec is set.
+  // Created by StartPeriodicTaskScheduler(), destroyed once the kAutoTune
+  // task is unregistered.
+  std::unique_ptr<AutoTuner> auto_tuner_;
 #endif
 
   // When set, we use a separate queue for writes that don't write to memtable.
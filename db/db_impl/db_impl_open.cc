@@ -7,6 +7,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include <cinttypes>
+#include <set>
 
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
@@ -26,6 +27,18 @@
 #include "util/rate_limiter.h"
 
 namespace ROCKSDB_NAMESPACE {
+namespace {
+// The tuner keeps the memtables within tuning_memory_budget, a
+// WriteBufferManager of the DB's own also holds them to it between the
+// tuner's rounds.
+bool SizeWriteBufferManagerByTuningBudget(const DBOptions& db_options) {
+  return !db_options.write_buffer_manager &&
+         db_options.db_write_buffer_size == 0 &&
+         db_options.tuning_policy != nullptr &&
+         db_options.tuning_memory_budget > 0;
+}
+}  // namespace
+
 Options SanitizeOptions(const std::string& dbname, const Options& src,
                         bool read_only, Status* logger_creation_s) {
   auto db_options =
@@ -66,6 +79,11 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src,
     }
   }
 
+  if (SizeWriteBufferManagerByTuningBudget(src)) {
+    // DBImpl::Open() leaves the block caches their share
+    result.write_buffer_manager.reset(new WriteBufferManager(
+        static_cast<size_t>(result.tuning_memory_budget)));
+  }
   if (!result.write_buffer_manager) {
     result.write_buffer_manager.reset(
         new WriteBufferManager(result.db_write_buffer_size));
@@ -1816,6 +1834,28 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   } else {
     assert(impl->init_logger_creation_s_.ok());
   }
+  if (SizeWriteBufferManagerByTuningBudget(db_options)) {
+    // The memtables get what the distinct block caches of the column
+    // families leave of the budget, as in DOTA_Tuner::MemtableBudget(), but
+    // at least one memtable.
+    std::set<const Cache*> block_caches;
+    uint64_t cache_bytes = 0;
+    for (const auto& cf : column_families) {
+      const auto* table_options =
+          cf.options.table_factory != nullptr
+              ? cf.options.table_factory->GetOptions<BlockBasedTableOptions>()
+              : nullptr;
+      if (table_options != nullptr && !table_options->no_block_cache &&
+          table_options->block_cache != nullptr &&
+          block_caches.insert(table_options->block_cache.get()).second) {
+        cache_bytes += table_options->block_cache->GetCapacity();
+      }
+    }
+    const uint64_t budget = db_options.tuning_memory_budget;
+    const uint64_t left = budget > cache_bytes ? budget - cache_bytes : 0;
+    impl->write_buffer_manager_->SetBufferSize(static_cast<size_t>(
+        std::max<uint64_t>(left, max_write_buffer_size)));
+  }
   s = impl->env_->CreateDirIfMissing(impl->immutable_db_options_.GetWalDir());
   if (s.ok()) {
     std::vector<std::string> paths;
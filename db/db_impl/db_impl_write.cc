@@ -289,6 +289,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                         disable_memtable, batch_cnt, pre_release_callback,
                         post_memtable_callback);
   StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
+  TuningLatencyTimer tuning_write_sw(immutable_db_options_.clock,
+                                     immutable_db_options_.tuning_latency.get(),
+                                     TuningLatency::kWrite);
 
   write_thread_.JoinBatchGroup(&w);
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
@@ -640,6 +643,9 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
                                   bool disable_memtable, uint64_t* seq_used) {
   PERF_TIMER_GUARD(write_pre_and_post_process_time);
   StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
+  TuningLatencyTimer tuning_write_sw(immutable_db_options_.clock,
+                                     immutable_db_options_.tuning_latency.get(),
+                                     TuningLatency::kWrite);
 
   WriteContext write_context;
 
@@ -813,6 +819,9 @@ Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
                                       const size_t sub_batch_cnt) {
   PERF_TIMER_GUARD(write_pre_and_post_process_time);
   StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
+  TuningLatencyTimer tuning_write_sw(immutable_db_options_.clock,
+                                     immutable_db_options_.tuning_latency.get(),
+                                     TuningLatency::kWrite);
 
   WriteThread::Writer w(write_options, my_batch, callback, log_ref,
                         false /*disable_memtable*/);
@@ -867,6 +876,9 @@ Status DBImpl::WriteImplWALOnly(
   WriteThread::Writer w(write_options, my_batch, callback, log_ref,
                         disable_memtable, sub_batch_cnt, pre_release_callback);
   StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
+  TuningLatencyTimer tuning_write_sw(immutable_db_options_.clock,
+                                     immutable_db_options_.tuning_latency.get(),
+                                     TuningLatency::kWrite);
 
   write_thread->JoinBatchGroup(&w);
   assert(w.state != WriteThread::STATE_PARALLEL_MEMTABLE_WRITER);
@@ -19,6 +19,7 @@
 #include "rocksdb/convenience.h"
 #include "rocksdb/rate_limiter.h"
 #include "rocksdb/stats_history.h"
+#include "rocksdb/utilities/tuning_policy.h"
 #include "test_util/sync_point.h"
 #include "test_util/testutil.h"
 #include "util/random.h"
@@ -601,6 +602,71 @@ TEST_F(DBOptionsTest, SetOptionsMayTriggerCompaction) {
   ASSERT_EQ("0,1", FilesPerLevel());
 }
 
+TEST_F(DBOptionsTest, SetOptionsMayTriggerFlush) {
+  Options options;
+  options.create_if_missing = true;
+  options.max_write_buffer_number = 4;
+  options.min_write_buffer_number_to_merge = 3;
+  options.env = env_;
+  Reopen(options);
+  for (int i = 0; i < 2; i++) {
+    ASSERT_OK(Put("foo", std::to_string(i)));
+    ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  }
+  // two immutable memtables wait for the third one
+  std::string num_imm;
+  ASSERT_TRUE(
+      db_->GetProperty("rocksdb.num-immutable-mem-table", &num_imm));
+  ASSERT_EQ("2", num_imm);
+
+  ASSERT_OK(
+      dbfull()->SetOptions({{"min_write_buffer_number_to_merge", "1"}}));
+  ASSERT_EQ(1, dbfull()->GetOptions().min_write_buffer_number_to_merge);
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  ASSERT_TRUE(
+      db_->GetProperty("rocksdb.num-immutable-mem-table", &num_imm));
+  ASSERT_EQ("0", num_imm);
+  ASSERT_EQ("1", FilesPerLevel());
+
+  // at least one memtable is left for the writes
+  ASSERT_OK(
+      dbfull()->SetOptions({{"min_write_buffer_number_to_merge", "8"}}));
+  ASSERT_EQ(3, dbfull()->GetOptions().min_write_buffer_number_to_merge);
+}
+
+TEST_F(DBOptionsTest, TuningMemoryBudgetLeavesBlockCache) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.env = env_;
+  ASSERT_OK(TuningPolicy::CreateFromString(ConfigOptions(), "ARK",
+                                           &options.tuning_policy));
+  options.tuning_memory_budget = 256 << 20;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(64 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_EQ(192U << 20, dbfull()
+                            ->immutable_db_options()
+                            .write_buffer_manager->buffer_size());
+  // the option stays as given
+  ASSERT_EQ(0U, dbfull()->GetDBOptions().db_write_buffer_size);
+
+  // a cache larger than the budget leaves one memtable
+  table_options.block_cache = NewLRUCache(512 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  const auto& write_buffer_manager =
+      dbfull()->immutable_db_options().write_buffer_manager;
+  ASSERT_EQ(options.write_buffer_size, write_buffer_manager->buffer_size());
+
+  // a DB's own db_write_buffer_size is kept
+  options.db_write_buffer_size = 32 << 20;
+  Reopen(options);
+  ASSERT_EQ(32U << 20, dbfull()
+                           ->immutable_db_options()
+                           .write_buffer_manager->buffer_size());
+}
+
 TEST_F(DBOptionsTest, SetBackgroundCompactionThreads) {
   Options options;
   options.create_if_missing = true;
@@ -627,6 +693,40 @@ TEST_F(DBOptionsTest, SetBackgroundFlushThreads) {
   ASSERT_EQ(3, dbfull()->TEST_BGFlushesAllowed());
 }
 
+TEST_F(DBOptionsTest, ShrinkBackgroundThreads) {
+  Options options;
+  options.create_if_missing = true;
+  options.max_background_flushes = 1;
+  options.max_background_compactions = 1;
+  options.env = env_;
+  Reopen(options);
+  ASSERT_OK(dbfull()->SetDBOptions({{"max_background_flushes", "3"},
+                                    {"max_background_compactions", "4"}}));
+  ASSERT_EQ(3, env_->GetBackgroundThreads(Env::Priority::HIGH));
+  ASSERT_EQ(4, env_->GetBackgroundThreads(Env::Priority::LOW));
+
+  // by default the pools keep the threads of the previous peak
+  ASSERT_OK(dbfull()->SetDBOptions({{"max_background_flushes", "2"},
+                                    {"max_background_compactions", "2"}}));
+  ASSERT_EQ(2, dbfull()->TEST_BGFlushesAllowed());
+  ASSERT_EQ(3, env_->GetBackgroundThreads(Env::Priority::HIGH));
+  ASSERT_EQ(4, env_->GetBackgroundThreads(Env::Priority::LOW));
+
+  options.max_background_flushes = 3;
+  options.max_background_compactions = 4;
+  options.shrink_background_threads = true;
+  Reopen(options);
+  ASSERT_OK(dbfull()->SetDBOptions({{"max_background_flushes", "1"},
+                                    {"max_background_compactions", "2"}}));
+  ASSERT_EQ(1, dbfull()->TEST_BGFlushesAllowed());
+  ASSERT_EQ(1, env_->GetBackgroundThreads(Env::Priority::HIGH));
+  ASSERT_EQ(2, env_->GetBackgroundThreads(Env::Priority::LOW));
+
+  // growing again still works after a shrink
+  ASSERT_OK(dbfull()->SetDBOptions({{"max_background_flushes", "2"}}));
+  ASSERT_EQ(2, env_->GetBackgroundThreads(Env::Priority::HIGH));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+}
 
 TEST_F(DBOptionsTest, SetBackgroundJobs) {
   Options options;
@@ -1064,6 +1064,47 @@ TEST_F(DBPropertiesTest, EstimatePendingCompBytes) {
   ASSERT_EQ(int_num, 0U);
 }
 
+TEST_F(DBPropertiesTest, TuningSnapshot) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_background_jobs = 4;
+  options.write_buffer_size = 1 << 20;
+  options.target_file_size_base = 2 << 20;
+  Reopen(options);
+
+  TuningSnapshot snapshot;
+  ASSERT_OK(db_->GetTuningSnapshot(&snapshot));
+  const uint64_t opened = snapshot.publish_count;
+  ASSERT_GT(opened, 0U);
+  ASSERT_EQ(4, snapshot.max_background_jobs);
+  ASSERT_EQ(1, snapshot.max_background_flushes);
+  ASSERT_EQ(3, snapshot.max_background_compactions);
+  ASSERT_EQ(1U << 20, snapshot.write_buffer_size);
+  ASSERT_EQ(2U << 20, snapshot.target_file_size_base);
+  ASSERT_EQ(0, snapshot.level_files[0]);
+  ASSERT_FALSE(snapshot.write_stopped);
+
+  // the memtable grows with the writes without a new publish
+  const uint64_t empty_memtable = snapshot.memtable_bytes;
+  ASSERT_OK(Put("k1", std::string(100000, 'x')));
+  ASSERT_OK(db_->GetTuningSnapshot(&snapshot));
+  ASSERT_EQ(opened, snapshot.publish_count);
+  ASSERT_GE(snapshot.memtable_bytes, empty_memtable + 100000);
+
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->GetTuningSnapshot(&snapshot));
+  ASSERT_GT(snapshot.publish_count, opened);
+  ASSERT_EQ(1, snapshot.level_files[0]);
+  ASSERT_GT(snapshot.level_bytes[0], 0U);
+  ASSERT_EQ(0, snapshot.immutable_memtables);
+
+  ASSERT_OK(dbfull()->SetDBOptions({{"max_background_jobs", "8"}}));
+  ASSERT_OK(db_->GetTuningSnapshot(&snapshot));
+  ASSERT_EQ(8, snapshot.max_background_jobs);
+  ASSERT_EQ(2, snapshot.max_background_flushes);
+  ASSERT_EQ(6, snapshot.max_background_compactions);
+}
+
 TEST_F(DBPropertiesTest, EstimateCompressionRatio) {
   if (!Snappy_Supported()) {
     return;
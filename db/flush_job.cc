@@ -311,6 +311,9 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker, FileMetaData* file_meta,
   if (s.ok() && file_meta != nullptr) {
     *file_meta = meta_;
   }
+  if (s.ok() && db_options_.tuning_trigger != nullptr) {
+    db_options_.tuning_trigger->Notify(TuningTrigger::kFlushCompleted);
+  }
   RecordFlushIOStats();
 
   // When measure_io_stats_ is true, the default 512 bytes is not enough.
@@ -1056,9 +1059,11 @@ Status FlushJob::WriteLevel0Table() {
   auto vfs = cfd_->current()->storage_info();
   metrics.l0_files = vfs->NumLevelFiles(vfs->base_level());
   metrics.memtable_ratio /= mems_.size();
-  metrics.write_out_bandwidth = stats.bytes_written / stats.micros;
+  metrics.write_out_bandwidth =
+      stats.micros == 0 ? 0 : stats.bytes_written / stats.micros;
+  metrics.cf_id = cfd_->GetID();
 
-  db_options_.flush_stats->push_back(metrics);
+  db_options_.flush_stats->Push(metrics);
 
 
   RecordFlushIOStats();
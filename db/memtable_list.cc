@@ -594,6 +594,10 @@ void MemTableList::Add(MemTable* m, autovector<MemTable*>* to_delete) {
   if (num_flush_not_started_ == 1) {
     imm_flush_needed.store(true, std::memory_order_release);
   }
+  if (tuning_trigger_ != nullptr &&
+      NumNotFlushed() == tuning_trigger_threshold_) {
+    tuning_trigger_->Notify(TuningTrigger::kImmutableMemtables);
+  }
   UpdateCachedValuesFromMemTableListVersion();
   ResetTrimHistoryNeeded();
 }
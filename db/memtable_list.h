@@ -23,6 +23,7 @@
 #include "rocksdb/options.h"
 #include "rocksdb/types.h"
 #include "util/autovector.h"
+#include "util/tuning_trigger.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -230,7 +231,8 @@ class MemTableList {
         flush_requested_(false),
         current_memory_usage_(0),
         current_memory_allocted_bytes_excluding_last_(0),
-        current_has_history_(false) {
+        current_has_history_(false),
+        tuning_trigger_threshold_(0) {
     current_->Ref();
   }
 
@@ -258,6 +260,12 @@ class MemTableList {
   // not yet started.
   bool IsFlushPending() const;
 
+  // How many immutable memtables a flush waits for, changed through
+  // SetOptions(). REQUIRES: DB mutex held
+  void SetMinWriteBufferNumberToMerge(int min_write_buffer_number_to_merge) {
+    min_write_buffer_number_to_merge_ = min_write_buffer_number_to_merge;
+  }
+
   // Returns true if there is at least one memtable that is pending flush or
   // flushing.
   bool IsFlushPendingOrRunning() const;
@@ -291,6 +299,14 @@ class MemTableList {
   // avoid flushing the memtable list upon addition of a memtable.
   void Add(MemTable* m, autovector<MemTable*>* to_delete);
 
+  // Add() notifies `trigger` when the number of memtables not flushed yet
+  // reaches `threshold`. DB mutex held.
+  void SetTuningTrigger(std::shared_ptr<TuningTrigger> trigger,
+                        int threshold) {
+    tuning_trigger_ = std::move(trigger);
+    tuning_trigger_threshold_ = threshold;
+  }
+
   // Returns an estimate of the number of bytes of data in use.
   size_t ApproximateMemoryUsage();
 
@@ -426,7 +442,7 @@ class MemTableList {
                                      autovector<MemTable*>* to_delete,
                                      InstrumentedMutex* mu);
 
-  const int min_write_buffer_number_to_merge_;
+  int min_write_buffer_number_to_merge_;
 
   MemTableListVersion* current_;
 
@@ -448,6 +464,9 @@ class MemTableList {
 
   // Cached value of current_->HasHistory().
   std::atomic<bool> current_has_history_;
+
+  std::shared_ptr<TuningTrigger> tuning_trigger_;
+  int tuning_trigger_threshold_;
 };
 
 // Installs memtable atomic flush results.
@@ -23,6 +23,7 @@ enum class PeriodicTaskType : uint8_t {
   kPersistStats,
   kFlushInfoLog,
   kRecordSeqnoTime,
+  kAutoTune,
   kMax,
 };
 
@@ -8,7 +8,9 @@
 
 #include "db/db_test_util.h"
 #include "env/composite_env_wrapper.h"
+#include "rocksdb/utilities/tuning_policy.h"
 #include "test_util/mock_time_env.h"
+#include "utilities/DOTA/auto_tuner.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -220,6 +222,72 @@ TEST_F(PeriodicTaskSchedulerTest, MultiEnv) {
   Close();
 }
 
+TEST_F(PeriodicTaskSchedulerTest, AutoTune) {
+  constexpr unsigned int kPeriodSec = 2;
+  Close();
+  Options options;
+  options.create_if_missing = true;
+  options.env = mock_env_.get();
+  options.auto_tune_period_sec = kPeriodSec;
+  options.auto_tune_gap_sec = 2 * kPeriodSec;
+  // the trigger's rate limit runs on the real clock
+  options.tuning_trigger_interval_ms = 1;
+
+  // no policy, no task
+  Reopen(options);
+  ASSERT_FALSE(dbfull()->TEST_GetPeriodicTaskScheduler().TEST_HasTask(
+      PeriodicTaskType::kAutoTune));
+  ASSERT_EQ(nullptr, dbfull()->TEST_GetAutoTuner());
+
+  ConfigOptions config_options;
+  ASSERT_OK(TuningPolicy::CreateFromString(config_options, "ARK",
+                                           &options.tuning_policy));
+  int auto_tune_counter = 0;
+  SyncPoint::GetInstance()->SetCallBack("DBImpl::AutoTune:StartRunning",
+                                        [&](void*) { auto_tune_counter++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Reopen(options);
+  const PeriodicTaskScheduler& scheduler =
+      dbfull()->TEST_GetPeriodicTaskScheduler();
+  ASSERT_TRUE(scheduler.TEST_HasTask(PeriodicTaskType::kAutoTune));
+  AutoTuner* auto_tuner = dbfull()->TEST_GetAutoTuner();
+  ASSERT_NE(nullptr, auto_tuner);
+  ASSERT_STREQ("ARK", auto_tuner->GetTuner()->policy()->Name());
+
+  for (int i = 0; i < 4; i++) {
+    dbfull()->TEST_WaitForPeridicTaskRun(
+        [&] { mock_clock_->MockSleepForSeconds(static_cast<int>(kPeriodSec)); });
+  }
+  ASSERT_GE(auto_tune_counter, 4);
+  // a tuning round every other tick
+  ASSERT_EQ(static_cast<uint64_t>(auto_tune_counter / 2),
+            auto_tuner->TuningRounds());
+
+  // a finished flush adds a round on the next tick, off the gap
+  if (auto_tune_counter % 2 != 0) {
+    auto_tuner->Tick();
+  }
+  uint64_t rounds = auto_tuner->TuningRounds();
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+  ASSERT_GT(dbfull()->immutable_db_options().tuning_trigger->Notifications(),
+            0U);
+  env_->SleepForMicroseconds(10 * 1000);
+  auto_tuner->Tick();
+  ASSERT_EQ(rounds + 1, auto_tuner->TuningRounds());
+  // the regular round
+  auto_tuner->Tick();
+  ASSERT_EQ(rounds + 2, auto_tuner->TuningRounds());
+  // nothing happened since
+  auto_tuner->Tick();
+  ASSERT_EQ(rounds + 2, auto_tuner->TuningRounds());
+
+  Close();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 #endif  // !ROCKSDB_LITE
 }  // namespace ROCKSDB_NAMESPACE
 
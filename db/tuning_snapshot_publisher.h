@@ -0,0 +1,118 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "rocksdb/tuning_snapshot.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Holds the last TuningSnapshot a DB published. The DB publishes under its
+// mutex whenever the state changes (a SuperVersion was installed or the DB
+// options changed); readers copy it without any lock. Every field is an
+// atomic of its own, so a read that races with a publish may mix fields of
+// two consecutive states, which is fine for tuning.
+class TuningSnapshotPublisher {
+ public:
+  TuningSnapshotPublisher() {
+    for (int i = 0; i < TuningSnapshot::kMaxLevels; i++) {
+      level_files_[i].store(0, std::memory_order_relaxed);
+      level_bytes_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  TuningSnapshotPublisher(const TuningSnapshotPublisher&) = delete;
+  TuningSnapshotPublisher& operator=(const TuningSnapshotPublisher&) = delete;
+
+  // `bytes_written` is the DB's running count of bytes written, the memtable
+  // sizes of later reads are advanced by what was written since.
+  void Publish(const TuningSnapshot& s, uint64_t bytes_written) {
+    memtable_bytes_.store(s.memtable_bytes, std::memory_order_relaxed);
+    active_memtable_bytes_.store(s.active_memtable_bytes,
+                                 std::memory_order_relaxed);
+    immutable_memtables_.store(s.immutable_memtables,
+                               std::memory_order_relaxed);
+    num_levels_.store(s.num_levels, std::memory_order_relaxed);
+    for (int i = 0; i < TuningSnapshot::kMaxLevels; i++) {
+      level_files_[i].store(s.level_files[i], std::memory_order_relaxed);
+      level_bytes_[i].store(s.level_bytes[i], std::memory_order_relaxed);
+    }
+    pending_compaction_bytes_.store(s.pending_compaction_bytes,
+                                    std::memory_order_relaxed);
+    write_stopped_.store(s.write_stopped, std::memory_order_relaxed);
+    write_delayed_.store(s.write_delayed, std::memory_order_relaxed);
+    delayed_write_rate_.store(s.delayed_write_rate, std::memory_order_relaxed);
+    max_background_jobs_.store(s.max_background_jobs,
+                               std::memory_order_relaxed);
+    max_background_flushes_.store(s.max_background_flushes,
+                                  std::memory_order_relaxed);
+    max_background_compactions_.store(s.max_background_compactions,
+                                      std::memory_order_relaxed);
+    write_buffer_size_.store(s.write_buffer_size, std::memory_order_relaxed);
+    target_file_size_base_.store(s.target_file_size_base,
+                                 std::memory_order_relaxed);
+    bytes_written_.store(bytes_written, std::memory_order_relaxed);
+    publish_count_.fetch_add(1, std::memory_order_release);
+  }
+
+  // Wait-free.
+  void Read(uint64_t bytes_written, TuningSnapshot* s) const {
+    s->publish_count = publish_count_.load(std::memory_order_acquire);
+    const uint64_t published_written =
+        bytes_written_.load(std::memory_order_relaxed);
+    const uint64_t written_since = bytes_written > published_written
+                                       ? bytes_written - published_written
+                                       : 0;
+    s->memtable_bytes =
+        memtable_bytes_.load(std::memory_order_relaxed) + written_since;
+    s->active_memtable_bytes =
+        active_memtable_bytes_.load(std::memory_order_relaxed) + written_since;
+    s->immutable_memtables =
+        immutable_memtables_.load(std::memory_order_relaxed);
+    s->num_levels = num_levels_.load(std::memory_order_relaxed);
+    for (int i = 0; i < TuningSnapshot::kMaxLevels; i++) {
+      s->level_files[i] = level_files_[i].load(std::memory_order_relaxed);
+      s->level_bytes[i] = level_bytes_[i].load(std::memory_order_relaxed);
+    }
+    s->pending_compaction_bytes =
+        pending_compaction_bytes_.load(std::memory_order_relaxed);
+    s->write_stopped = write_stopped_.load(std::memory_order_relaxed);
+    s->write_delayed = write_delayed_.load(std::memory_order_relaxed);
+    s->delayed_write_rate = delayed_write_rate_.load(std::memory_order_relaxed);
+    s->max_background_jobs =
+        max_background_jobs_.load(std::memory_order_relaxed);
+    s->max_background_flushes =
+        max_background_flushes_.load(std::memory_order_relaxed);
+    s->max_background_compactions =
+        max_background_compactions_.load(std::memory_order_relaxed);
+    s->write_buffer_size = write_buffer_size_.load(std::memory_order_relaxed);
+    s->target_file_size_base =
+        target_file_size_base_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<uint64_t> publish_count_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+  std::atomic<uint64_t> memtable_bytes_{0};
+  std::atomic<uint64_t> active_memtable_bytes_{0};
+  std::atomic<int> immutable_memtables_{0};
+  std::atomic<int> num_levels_{0};
+  std::atomic<int> level_files_[TuningSnapshot::kMaxLevels];
+  std::atomic<uint64_t> level_bytes_[TuningSnapshot::kMaxLevels];
+  std::atomic<uint64_t> pending_compaction_bytes_{0};
+  std::atomic<bool> write_stopped_{false};
+  std::atomic<bool> write_delayed_{false};
+  std::atomic<uint64_t> delayed_write_rate_{0};
+  std::atomic<int> max_background_jobs_{0};
+  std::atomic<int> max_background_flushes_{0};
+  std::atomic<int> max_background_compactions_{0};
+  std::atomic<uint64_t> write_buffer_size_{0};
+  std::atomic<uint64_t> target_file_size_base_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
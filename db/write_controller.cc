@@ -15,7 +15,9 @@
 namespace ROCKSDB_NAMESPACE {
 
 std::unique_ptr<WriteControllerToken> WriteController::GetStopToken() {
-  ++total_stopped_;
+  if (0 == total_stopped_++ && tuning_trigger_ != nullptr) {
+    tuning_trigger_->Notify(TuningTrigger::kWriteStop);
+  }
   return std::unique_ptr<WriteControllerToken>(new StopWriteToken(this));
 }
 
@@ -25,6 +27,9 @@ std::unique_ptr<WriteControllerToken> WriteController::GetDelayToken(
     // Starting delay, so reset counters.
     next_refill_time_ = 0;
     credit_in_bytes_ = 0;
+    if (tuning_trigger_ != nullptr) {
+      tuning_trigger_->Notify(TuningTrigger::kWriteDelay);
+    }
   }
   // NOTE: for simplicity, any current credit_in_bytes_ or "debt" in
   // next_refill_time_ will be based on an old rate. This rate will apply
@@ -10,6 +10,7 @@
 #include <atomic>
 #include <memory>
 #include "rocksdb/rate_limiter.h"
+#include "util/tuning_trigger.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -84,6 +85,11 @@ class WriteController {
 
   RateLimiter* low_pri_rate_limiter() { return low_pri_rate_limiter_.get(); }
 
+  // Notified when writes enter the stopped or the delayed state.
+  void SetTuningTrigger(std::shared_ptr<TuningTrigger> trigger) {
+    tuning_trigger_ = std::move(trigger);
+  }
+
  private:
   uint64_t NowMicrosMonotonic(SystemClock* clock);
 
@@ -106,6 +112,8 @@ class WriteController {
   uint64_t delayed_write_rate_;
 
   std::unique_ptr<RateLimiter> low_pri_rate_limiter_;
+
+  std::shared_ptr<TuningTrigger> tuning_trigger_;
 };
 
 class WriteControllerToken {
@@ -390,15 +390,6 @@ class PosixEnv : public CompositeEnv {
   // for FEAT usage
   //
 
-  std::vector<std::pair<size_t, uint64_t>> GetThreadWaitingTime() {
-    std::vector<std::pair<size_t, uint64_t>> results;
-    for (uint64_t i = 0; i < thread_pools_.size(); i++) {
-      auto waiting_time_list = thread_pools_[i].GetThreadWaitingTime();
-      results.insert(results.end(), waiting_time_list->begin(),
-                     waiting_time_list->end());
-    }
-    return results;
-  }
   std::vector<std::pair<std::string, uint64_t>> GetThreadCreatingTime() {
     std::vector<std::pair<std::string, uint64_t>> results;
     for (uint64_t i = 0; i < thread_pools_.size(); i++) {
@@ -417,10 +408,10 @@ class PosixEnv : public CompositeEnv {
     }
     return ss.str();
   }
-  std::vector<std::pair<size_t, uint64_t>>* GetThreadPoolWaitingTime(
-      Env::Priority priority) override {
+  uint64_t GetThreadPoolWaitingTime(Env::Priority priority,
+                                    uint64_t* cursor) override {
     assert(priority >= Priority::BOTTOM && priority <= Priority::HIGH);
-    return thread_pools_[priority].GetThreadWaitingTime();
+    return thread_pools_[priority].GetThreadWaitingTime(cursor);
   }
 
  private:
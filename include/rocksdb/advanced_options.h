@@ -672,6 +672,19 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   uint64_t max_compaction_bytes = 0;
 
+  // The most automatic compactions of this column family that may run at once
+  // into each output level, indexed by the output level. Intra-L0 compactions
+  // count for level 0. A missing entry or a value <= 0 means no limit, so the
+  // default leaves every compaction to max_background_compactions. Capping the
+  // deeper levels keeps background slots free for L0->base level compactions,
+  // which are the ones write stalls wait for. Only leveled compaction honors
+  // it, manual compactions are not limited.
+  //
+  // Default: empty
+  //
+  // Dynamically changeable through SetOptions() API
+  std::vector<int> max_compactions_per_output_level;
+
   // All writes will be slowed down to at least delayed_write_rate if estimated
   // bytes needed to be compaction exceed this threshold.
   //
@@ -19,6 +19,7 @@ struct FlushMetrics {
   double write_out_bandwidth = 0.0;
   double start_time = 0.0;
   int l0_files = 0;
+  uint32_t cf_id = 0;
 };
 
 struct QuicksandMetrics {
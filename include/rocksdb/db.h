@@ -25,6 +25,7 @@
 #include "rocksdb/sst_file_writer.h"
 #include "rocksdb/thread_status.h"
 #include "rocksdb/transaction_log.h"
+#include "rocksdb/tuning_snapshot.h"
 #include "rocksdb/types.h"
 #include "rocksdb/version.h"
 #include "rocksdb/wide_columns.h"
@@ -1189,6 +1190,15 @@ class DB {
   virtual bool GetAggregatedIntProperty(const Slice& property,
                                         uint64_t* value) = 0;
 
+  // The state an option tuner reads every round: memtable bytes, LSM shape,
+  // pending compaction bytes, write stalls and background limits. The DB
+  // keeps it up to date on its write, flush and compaction paths, so taking
+  // it neither locks the DB nor copies options, unlike GetOptions() and the
+  // properties.
+  virtual Status GetTuningSnapshot(TuningSnapshot* /*snapshot*/) {
+    return Status::NotSupported("GetTuningSnapshot() is not implemented.");
+  }
+
   // Flags for DB::GetSizeApproximation that specify whether memtable
   // stats should be included, or file stats approximation or both
   enum class SizeApproximationFlags : uint8_t {
@@ -682,9 +682,13 @@ class Env : public Customizable {
   virtual std::string GetThreadPoolTimeStateString() {
     return "haven't been implemented";
   }
-  virtual std::vector<std::pair<size_t, uint64_t>>* GetThreadPoolWaitingTime(
-      Env::Priority /*priority*/) {
-    return nullptr;
+  // Sum of the micros the threads of the given pool spent waiting for a job
+  // since *cursor, and advance *cursor past the consumed samples. Start from
+  // *cursor == 0. The samples live in a fixed-size ring, so a caller that
+  // polls too rarely only sees the most recent ones.
+  virtual uint64_t GetThreadPoolWaitingTime(Env::Priority /*priority*/,
+                                            uint64_t* /*cursor*/) {
+    return 0;
   }
  protected:
   // The pointer to an internal structure that will update the
@@ -1628,6 +1632,14 @@ class EnvWrapper : public Env {
 
   uint64_t GetThreadID() const override { return target_.env->GetThreadID(); }
 
+  std::string GetThreadPoolTimeStateString() override {
+    return target_.env->GetThreadPoolTimeStateString();
+  }
+  uint64_t GetThreadPoolWaitingTime(Env::Priority priority,
+                                    uint64_t* cursor) override {
+    return target_.env->GetThreadPoolWaitingTime(priority, cursor);
+  }
+
   std::string GenerateUniqueId() override {
     return target_.env->GenerateUniqueId();
   }
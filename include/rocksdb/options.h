@@ -53,6 +53,7 @@ class MemTableRepFactory;
 class RateLimiter;
 class Slice;
 class Statistics;
+class TuningPolicy;
 class InternalKeyComparator;
 class WalFilter;
 class FileSystem;
@@ -381,6 +382,16 @@ enum class WALRecoveryMode : char {
   kSkipAnyCorruptedRecords = 0x03,
 };
 
+// What the option tuner optimizes for, see DBOptions::tuning_objective.
+enum class TuningObjective : char {
+  // As many operations per second as possible.
+  kThroughput = 0x00,
+  // A low p99 latency of the foreground writes and reads, even at some cost
+  // in throughput. The DB measures the latency of every write and read for
+  // the tuner.
+  kLatency = 0x01,
+};
+
 struct DbPath {
   std::string path;
   uint64_t target_size;  // Target size of total files under the path, in byte.
@@ -1401,6 +1412,58 @@ struct DBOptions {
   // Here is the max size of target system. It surppose to be immutable, but
   // who knows.
   uint64_t max_memtable_size = 512 << 20;
+  // When true, lowering max_background_flushes/compactions/jobs through
+  // SetDBOptions() also shrinks the Env's HIGH/LOW thread pools to the new
+  // limits. Excess threads retire once their current job finishes. Only
+  // enable this if the Env's pools are not shared with other DB instances
+  // that still need the threads.
+  bool shrink_background_threads = false;
+  // The policy the option tuner follows when it runs against this DB, e.g.
+  // "tuning_policy=ARK" in an options string. See
+  // rocksdb/utilities/tuning_policy.h for the built-in policies.
+  // A tuned DB counts the bytes it writes and reads through its FileSystem,
+  // so that the tuner learns the bandwidth of the device. With `statistics`
+  // set, ARK also tells write-, read- and scan-heavy phases apart and bounds
+  // its memtable, SST and thread changes for the phase.
+  // nullptr means the DB is not tuned.
+  std::shared_ptr<TuningPolicy> tuning_policy = nullptr;
+  // If non-zero and tuning_policy is set, the DB runs tuning_policy itself
+  // as a periodic task every auto_tune_period_sec seconds, without any
+  // reporter agent.
+  unsigned int auto_tune_period_sec = 0;
+  // Seconds between two tuning decisions of that task. Rounded up to a
+  // multiple of auto_tune_period_sec.
+  unsigned int auto_tune_gap_sec = 1;
+  // Besides its regular rounds, the tuner is woken up when writes get
+  // delayed or stopped, when a column family is one memtable away from a
+  // memtable stall and when a flush finishes. These extra rounds are at least
+  // this many milliseconds apart. 0 disables the event-driven rounds.
+  unsigned int tuning_trigger_interval_ms = 0;
+  // If not empty, the tuner records every round (its inputs, its ARK
+  // counters and the changes it decided) to this file, which the
+  // tuner_replay tool can run through other tuning policies offline.
+  std::string tuner_trace_file = "";
+  // If not empty, the tuner saves what it learned (its score history, its
+  // ARK counters and the options it settled on) to this file whenever it
+  // changed something, and a reopened DB resumes from there instead of
+  // starting over from the configured options. The file is replaced through
+  // a synced temporary file, a crash leaves either the old or the new state.
+  std::string tuner_state_file = "";
+  // Whether the tuner trades throughput for tail latency. With kLatency the
+  // tuner scores the p99 latency of the writes and reads of every round and
+  // rolls back changes that made it worse.
+  TuningObjective tuning_objective = TuningObjective::kThroughput;
+  // Memory the memtables and block caches of a tuned DB may take together,
+  // all memtables of every column family counted (max_write_buffer_number
+  // of them). The tuner never grows write_buffer_size beyond what the block
+  // caches leave of it, and scales the memtables down once they do not fit.
+  // Unless the DB was given a WriteBufferManager or db_write_buffer_size,
+  // its own WriteBufferManager also flushes once the memtables take what
+  // the block caches of the column families it was opened with leave of the
+  // budget. db_write_buffer_size itself stays 0. To charge the memtables to
+  // the block cache, give the DB a WriteBufferManager with that cache.
+  // 0 means no budget.
+  uint64_t tuning_memory_budget = 0;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -0,0 +1,51 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// What an option tuner reads from a DB every round, see
+// DB::GetTuningSnapshot(). Sizes are in bytes and summed over all column
+// families unless noted otherwise.
+struct TuningSnapshot {
+  static constexpr int kMaxLevels = 16;
+
+  // Bumped whenever the DB published a new state, i.e. after every memtable
+  // switch, flush, compaction and option change.
+  uint64_t publish_count = 0;
+
+  // Memtables. The sizes are measured when the state is published and
+  // advanced by the bytes written since.
+  uint64_t memtable_bytes = 0;  // active and immutable
+  uint64_t active_memtable_bytes = 0;
+  int immutable_memtables = 0;  // not flushed yet
+
+  // LSM shape. Levels beyond kMaxLevels are counted in the last one.
+  int num_levels = 0;
+  int level_files[kMaxLevels] = {};
+  uint64_t level_bytes[kMaxLevels] = {};
+  uint64_t pending_compaction_bytes = 0;
+
+  // Write stalls
+  bool write_stopped = false;
+  bool write_delayed = false;
+  uint64_t delayed_write_rate = 0;
+
+  // Background limits, with the flush and compaction split the DB derives
+  // from max_background_jobs
+  int max_background_jobs = 0;
+  int max_background_flushes = 0;
+  int max_background_compactions = 0;
+  // of the default column family
+  uint64_t write_buffer_size = 0;
+  uint64_t target_file_size_base = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -7,9 +7,20 @@
 #pragma once
 #include <iostream>
 #include <algorithm>
+#include <map>
+
+#include "rocksdb/rate_limiter.h"
+#include "rocksdb/utilities/tuning_policy.h"
+#include "util/tuning_bandwidth.h"
+#include "util/tuning_workload.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+struct TunerState;
+struct TunerTraceHeader;
+struct TunerTraceRecord;
+class TunerTraceWriter;
+
 enum ThreadStallLevels : int {
   //  kLowFlush,
   kL0Stall,
@@ -46,6 +57,16 @@ struct SystemScores {
   double compaction_idle_time;  // calculate by idle calculating,flush and
                                 // compaction stats separately
   int flush_numbers;
+  // Feedback of the workload
+  double interval_qps;  // operations per sec
+  double stall_ratio;   // share of the round the writes were stalled
+  // p99 latency of the round in micros, 0 unless the tuning objective is
+  // TuningObjective::kLatency
+  double write_latency_p99;
+  double read_latency_p99;
+  // share of the device bandwidth the DB learned it sustains, used by the
+  // round's reads and writes, 0 while the bandwidth is unknown
+  double io_utilization;
 
   SystemScores() {
     memtable_speed = 0.0;
@@ -58,9 +79,15 @@ struct SystemScores {
     l0_drop_ratio = 0.0;
     estimate_compaction_bytes = 0.0;
     disk_bandwidth = 0.0;
+    flush_idle_time = 0.0;
     compaction_idle_time = 0.0;
     flush_numbers = 0;
     flush_gap_time = 0;
+    interval_qps = 0.0;
+    stall_ratio = 0.0;
+    write_latency_p99 = 0.0;
+    read_latency_p99 = 0.0;
+    io_utilization = 0.0;
   }
   void Reset() {
     memtable_speed = 0.0;
@@ -72,9 +99,15 @@ struct SystemScores {
     l0_drop_ratio = 0.0;
     estimate_compaction_bytes = 0.0;
     disk_bandwidth = 0.0;
+    flush_idle_time = 0.0;
     compaction_idle_time = 0.0;
     flush_numbers = 0;
     flush_gap_time = 0;
+    interval_qps = 0.0;
+    stall_ratio = 0.0;
+    write_latency_p99 = 0.0;
+    read_latency_p99 = 0.0;
+    io_utilization = 0.0;
   }
   SystemScores operator-(const SystemScores& a);
   SystemScores operator+(const SystemScores& a);
@@ -88,31 +121,123 @@ struct ChangePoint {
   std::string value;
   int change_timing;
   bool db_width;
+  // the column family a non db_width change applies to
+  uint32_t cf_id = 0;
 };
 enum OpType : int { kLinearIncrease, kHalf, kKeep };
+
+// What the tuner knows about one column family. The scores are refreshed
+// every round, the pressure counters and the decided ops carry over.
+struct ColumnFamilyTuningState {
+  uint32_t id = 0;
+  std::string name;
+  // scores of this round, same units as SystemScores
+  double active_size_ratio = 0.0;
+  int immutable_number = 0;
+  double l0_num = 0.0;
+  double estimate_compaction_bytes = 0.0;
+  int flush_numbers = 0;
+  // current mutable options
+  uint64_t write_buffer_size = 0;
+  uint64_t target_file_size_base = 0;
+  int max_write_buffer_number = 0;
+  int min_write_buffer_number_to_merge = 0;
+  int level0_file_num_compaction_trigger = 0;
+  int level0_slowdown_writes_trigger = 0;
+  int level0_stop_writes_trigger = 0;
+  uint64_t soft_pending_compaction_bytes_limit = 0;
+  uint64_t hard_pending_compaction_bytes_limit = 0;
+  // The write stall limits as configured, before ARK raised them. l0_num and
+  // estimate_compaction_bytes are scored against these.
+  int base_level0_slowdown_writes_trigger = 0;
+  int base_level0_stop_writes_trigger = 0;
+  uint64_t base_soft_pending_compaction_bytes_limit = 0;
+  uint64_t base_hard_pending_compaction_bytes_limit = 0;
+  std::vector<int> max_compactions_per_output_level;
+  // the shape of the LSM tree
+  int num_levels = 0;
+  int base_level = 0;
+  // ARK history
+  int compaction_pressure_score = 0;
+  int compaction_relax_counter = 0;
+  int memtable_relax_counter = 0;
+  bool memtable_pressure = false;
+  OpType batch_op = kKeep;
+  OpType sstable_op = kKeep;
+  // max_write_buffer_number and min_write_buffer_number_to_merge
+  OpType write_buffer_number_op = kKeep;
+  OpType merge_width_op = kKeep;
+  // scores of the previous round and the rounds L0 grew beyond its base
+  // slowdown trigger in a row
+  double prev_l0_num = 0.0;
+  double prev_estimate_compaction_bytes = 0.0;
+  int l0_growth_rounds = 0;
+  // all four write stall limits, kHalf restores them
+  OpType stall_limit_op = kKeep;
+  // the compactions into the levels below the base level, kHalf caps them
+  // and kLinearIncrease lifts the caps
+  OpType deep_compaction_op = kKeep;
+};
+// What ARK carries from one round to the next.
+struct ArkCounters {
+  int memtable_pressure_score = 0;
+  int compaction_pressure_score = 0;
+  int memtable_relax_counter = 0;
+  int compaction_relax_counter = 0;
+  int stall_suspect_counter = 0;
+  bool operator==(const ArkCounters& o) const {
+    return memtable_pressure_score == o.memtable_pressure_score &&
+           compaction_pressure_score == o.compaction_pressure_score &&
+           memtable_relax_counter == o.memtable_relax_counter &&
+           compaction_relax_counter == o.compaction_relax_counter &&
+           stall_suspect_counter == o.stall_suspect_counter;
+  }
+  bool operator!=(const ArkCounters& o) const { return !(*this == o); }
+};
 struct TuningOP {
   OpType BatchOp;
   OpType ThreadOp;
   OpType FlushThreadOp;
   OpType CompactionThreadOp;
   OpType SSTableOp;
+  // the bytes per second of the DB's RateLimiter
+  OpType RateLimitOp;
+  // immutable memtable slots (max_write_buffer_number) and memtables merged
+  // per flush (min_write_buffer_number_to_merge)
+  OpType WriteBufferNumberOp;
+  OpType MergeWidthOp;
+  // the L0 slowdown/stop triggers and the soft/hard pending compaction
+  // bytes limits, kHalf restores them
+  OpType StallLimitOp;
+  // max_compactions_per_output_level of the levels below the base level
+  OpType DeepCompactionOp;
   TuningOP(OpType batch = kKeep, OpType thread = kKeep,
            OpType flush = kKeep, OpType compaction = kKeep,
-           OpType sstable = kKeep)
+           OpType sstable = kKeep, OpType rate_limit = kKeep,
+           OpType write_buffer_number = kKeep, OpType merge_width = kKeep,
+           OpType stall_limit = kKeep, OpType deep_compaction = kKeep)
       : BatchOp(batch),
         ThreadOp(thread),
         FlushThreadOp(flush),
         CompactionThreadOp(compaction),
-        SSTableOp(sstable) {}
+        SSTableOp(sstable),
+        RateLimitOp(rate_limit),
+        WriteBufferNumberOp(write_buffer_number),
+        MergeWidthOp(merge_width),
+        StallLimitOp(stall_limit),
+        DeepCompactionOp(deep_compaction) {}
 };
+// The change point setting the bytes per second of the DB's RateLimiter. It
+// is not a DB option, TuningExecutor applies it to
+// ImmutableDBOptions::rate_limiter.
+constexpr char kRateLimiterBytesPerSec[] = "rate_limiter_bytes_per_sec";
 class DOTA_Tuner {
  protected:
   const Options default_opts;
   uint64_t tuning_rounds;
   Options current_opt;
-  Version* version;
-  ColumnFamilyData* cfd;
-  VersionStorageInfo* vfs;
+  // what the DB published last, read once per round
+  TuningSnapshot snapshot_;
   DBImpl* running_db_;
   int64_t* last_report_ptr;
   std::atomic<int64_t>* total_ops_done_ptr_;
@@ -122,8 +247,13 @@ class DOTA_Tuner {
   uint64_t flush_list_accessed, compaction_list_accessed;
   ThreadStallLevels last_thread_states;
   BatchSizeStallLevels last_batch_stat;
-  std::shared_ptr<std::vector<FlushMetrics>> flush_list_from_opt_ptr;
-  std::shared_ptr<std::vector<QuicksandMetrics>> compaction_list_from_opt_ptr;
+  std::shared_ptr<MetricsRingBuffer<FlushMetrics>> flush_list_from_opt_ptr;
+  std::shared_ptr<MetricsRingBuffer<QuicksandMetrics>>
+      compaction_list_from_opt_ptr;
+  // reused every round so that scoring does not allocate
+  std::vector<FlushMetrics> flush_metric_list;
+  // every live column family, keyed by id
+  std::map<uint32_t, ColumnFamilyTuningState> cf_states_;
   SystemScores max_scores;
   SystemScores avg_scores;
   uint64_t last_flush_thread_len;
@@ -137,6 +267,109 @@ class DOTA_Tuner {
   double FEA_gap_threshold = 1;
   double TEA_slow_flush = 0.5;
   uint64_t last_non_zero_flush = 0;
+  // how long the previous batch of changes took to apply
+  uint64_t last_apply_micros_ = 0;
+  // when the previous round was scored, event-driven rounds come early
+  uint64_t last_score_micros_ = 0;
+  // ARK's closed loop. After a batch of changes ARK watches the next
+  // feedback_rounds rounds and rolls the batch back when the throughput
+  // dropped or the write stalls grew beyond the tolerances. Under the latency
+  // objective the p99 latencies are judged instead of the throughput. A knob
+  // that was rolled back, or that reversed its direction twice in
+  // ping_pong_rounds rounds, is left alone for cool_down_rounds rounds.
+  // Whatever the policy decides, a knob keeps a value for at least
+  // min_dwell_rounds rounds and does not move by less than hysteresis_band
+  // of it.
+  struct PendingChange {
+    bool active = false;
+    int rounds = 0;
+    double qps_before = 0.0;
+    double stall_before = 0.0;
+    double qps_after = 0.0;
+    double stall_after = 0.0;
+    double write_p99_before = 0.0;
+    double read_p99_before = 0.0;
+    double write_p99_after = 0.0;
+    double read_p99_after = 0.0;
+    // restores the options changed by the batch
+    std::vector<ChangePoint> undo;
+    int flush_threads = 0;
+    int compaction_threads = 0;
+    uint64_t rate_limit = 0;
+  };
+  struct KnobHistory {
+    bool changed = false;
+    int direction = 0;
+    uint64_t changed_round = 0;
+    int reversals = 0;
+    uint64_t cool_down_until = 0;
+  };
+  PendingChange pending_change_;
+  std::map<std::string, KnobHistory> knob_history_;
+  uint64_t ark_rounds_ = 0;
+  uint64_t rolled_back_changes_ = 0;
+  int feedback_rounds = 2;
+  double qps_tolerance = 0.1;
+  double stall_tolerance = 0.05;
+  uint64_t ping_pong_rounds = 8;
+  uint64_t cool_down_rounds = 10;
+  uint64_t min_dwell_rounds = 3;
+  double hysteresis_band = 0.05;
+  uint64_t last_ops_done_ = 0;
+  uint64_t last_stall_micros_ = 0;
+  // the device bandwidth, learned from the bytes counted by the DB's
+  // tuning_fs
+  TuningBandwidth bandwidth_;
+  // Share of the learned bandwidth from which more background threads only
+  // queue I/O. Above it ARK moves threads between flushes and compactions
+  // but does not add any.
+  double bandwidth_congestion_threshold = 0.9;
+  // While the compactions keep up, ARK raises the write stall limits of a
+  // column family in steps of the configured ones, up to this many times
+  // them. They are restored once L0, and so the read amplification, keeps
+  // growing beyond the configured slowdown trigger.
+  int max_stall_limit_ratio = 4;
+  // p99 growth, relative, that rolls a change back under the latency
+  // objective
+  double latency_tolerance = 0.2;
+  TuningObjective objective_ = TuningObjective::kThroughput;
+  // The workload phase, told from the DB's Statistics tickers. Without
+  // Statistics it stays kUnknown and ARK keeps its default bounds.
+  TuningWorkload workload_;
+  TuningWorkload::Phase workload_phase_ = TuningWorkload::kUnknown;
+  // the phase whose bounds ARK applied last
+  TuningWorkload::Phase ark_phase_ = TuningWorkload::kUnknown;
+  // ARK's bounds in a workload phase. Ingest favours large memtables and
+  // leaves the threads to the flushes, serving keeps the memtables small and
+  // L0 shallow, scans also want fewer, larger SSTs.
+  struct PhaseBounds {
+    uint64_t min_memtable_size;
+    uint64_t max_memtable_size;
+    uint64_t min_sstable_size;
+    int min_compaction_threads;
+    int max_compaction_threads;
+    // l0_num from which L0 counts as compaction pressure
+    double l0_pressure_threshold;
+  };
+  PhaseBounds PhaseBoundsFor(TuningWorkload::Phase phase) const;
+  // Returns true when this round is spent on the last change, either still
+  // watching it or rolling it back into *change_list.
+  bool JudgeLastChange(std::vector<ChangePoint>* change_list);
+  // Whether `knob` may move from `from` to `to` this round, records the move.
+  bool AllowKnobChange(const std::string& knob, uint64_t from, uint64_t to);
+  // AllowKnobChange() in two steps, for targets that may still move before
+  // they are emitted: KnobMayChange() only checks (a ping-pong starts the
+  // cool-down), RecordKnobChange() records what was emitted.
+  bool KnobMayChange(const std::string& knob, uint64_t from, uint64_t to);
+  void RecordKnobChange(const std::string& knob, uint64_t from, uint64_t to);
+  void ExpectFeedback(std::vector<ChangePoint>&& undo, int flush_threads,
+                      int compaction_threads, uint64_t rate_limit);
+  // While a round is traced, the inputs and the decision are recorded here.
+  TunerTraceRecord* trace_record_ = nullptr;
+  // While a round is replayed, the inputs come from here instead of the DB.
+  const TunerTraceRecord* replay_input_ = nullptr;
+  void RecordRoundInputs(const SystemScores& score);
+  SystemScores ReplayRoundInputs();
   void UpdateSystemStats() { UpdateSystemStats(running_db_); }
 
  public:
@@ -165,6 +398,7 @@ class DOTA_Tuner {
         core_num(running_db->immutable_db_options().core_number),
         max_memtable_size(
             running_db->immutable_db_options().max_memtable_size) {
+    objective_ = running_db->immutable_db_options().tuning_objective;
     this->last_report_ptr = last_report_op_ptr;
     this->total_ops_done_ptr_ = total_ops_done_ptr;
     max_thread = opt.max_background_jobs > 0 ? opt.max_background_jobs
@@ -179,6 +413,48 @@ class DOTA_Tuner {
             : std::max(1, max_thread - current_flush_threads_);
     min_sstable_size = std::max<uint64_t>(opt.target_file_size_base, 1);
     max_sstable_size = max_memtable_size;
+    default_rate_limit_ =
+        opt.rate_limiter != nullptr ? opt.rate_limiter->GetBytesPerSecond() : 0;
+    rate_limit_ = default_rate_limit_;
+  }
+  // A tuner without a DB, it can only replay traced rounds.
+  DOTA_Tuner(const Options opt, Env* env, uint64_t gap_sec)
+      : default_opts(opt),
+        tuning_rounds(0),
+        current_opt(opt),
+        running_db_(nullptr),
+        last_report_ptr(nullptr),
+        total_ops_done_ptr_(nullptr),
+        scores(),
+        gradients(0),
+        current_sec(0),
+        flush_list_accessed(0),
+        compaction_list_accessed(0),
+        last_thread_states(kL0Stall),
+        last_batch_stat(kTinyMemtable),
+        max_scores(),
+        last_flush_thread_len(0),
+        last_compaction_thread_len(0),
+        env_(env),
+        tuning_gap(gap_sec),
+        core_num(static_cast<int>(opt.core_number)),
+        max_memtable_size(opt.max_memtable_size) {
+    objective_ = opt.tuning_objective;
+    max_thread = opt.max_background_jobs > 0 ? opt.max_background_jobs
+                                             : max_thread;
+    current_flush_threads_ =
+        opt.max_background_flushes > 0
+            ? opt.max_background_flushes
+            : std::max(1, max_thread / 4);
+    current_compaction_threads_ =
+        opt.max_background_compactions > 0
+            ? opt.max_background_compactions
+            : std::max(1, max_thread - current_flush_threads_);
+    min_sstable_size = std::max<uint64_t>(opt.target_file_size_base, 1);
+    max_sstable_size = max_memtable_size;
+    default_rate_limit_ =
+        opt.rate_limiter != nullptr ? opt.rate_limiter->GetBytesPerSecond() : 0;
+    rate_limit_ = default_rate_limit_;
   }
   void set_idle_ratio(double idle_ra) { idle_threshold = idle_ra; }
   void set_gap_threshold(double ng_threshold) {
@@ -187,6 +463,23 @@ class DOTA_Tuner {
   void set_slow_flush_threshold(double sf_threshold) {
     this->TEA_slow_flush = sf_threshold;
   }
+  void ReportApplyLatency(uint64_t micros) { last_apply_micros_ = micros; }
+  void set_feedback_tolerance(double qps_drop, double stall_growth,
+                              double latency_growth = 0.2) {
+    qps_tolerance = qps_drop;
+    stall_tolerance = stall_growth;
+    latency_tolerance = latency_growth;
+  }
+  void set_safety_envelope(uint64_t dwell_rounds, double band) {
+    min_dwell_rounds = dwell_rounds;
+    hysteresis_band = band;
+  }
+  void set_max_stall_limit_ratio(int ratio) {
+    max_stall_limit_ratio = std::max(1, ratio);
+  }
+  void set_objective(TuningObjective objective) { objective_ = objective; }
+  TuningObjective objective() const { return objective_; }
+  uint64_t RolledBackChanges() const { return rolled_back_changes_; }
   virtual ~DOTA_Tuner();
 
   inline void UpdateMaxScore(SystemScores& current_score) {
@@ -239,14 +532,18 @@ class DOTA_Tuner {
   }
 
   void ResetTuner() { tuning_rounds = 0; }
+  // Only the options the tuner changes are refreshed.
   void UpdateSystemStats(DBImpl* running_db) {
-    current_opt = running_db->GetOptions();
-    version = running_db->GetVersionSet()
-                  ->GetColumnFamilySet()
-                  ->GetDefault()
-                  ->current();
-    cfd = version->cfd();
-    vfs = version->storage_info();
+    if (!running_db->GetTuningSnapshot(&snapshot_).ok() ||
+        snapshot_.publish_count == 0) {
+      return;
+    }
+    current_opt.max_background_jobs = snapshot_.max_background_jobs;
+    current_opt.max_background_flushes = snapshot_.max_background_flushes;
+    current_opt.max_background_compactions =
+        snapshot_.max_background_compactions;
+    current_opt.write_buffer_size = snapshot_.write_buffer_size;
+    current_opt.target_file_size_base = snapshot_.target_file_size_base;
   }
   virtual void DetectTuningOperations(int secs_elapsed,
                                       std::vector<ChangePoint>* change_list);
@@ -269,16 +566,32 @@ class DOTA_Tuner {
   const std::string max_flush_threads_opt = "max_background_flushes";
   const std::string max_compaction_threads_opt = "max_background_compactions";
   const std::string memtable_number = "max_write_buffer_number";
+  const std::string merge_width = "min_write_buffer_number_to_merge";
+  const std::string l0_slowdown_opt = "level0_slowdown_writes_trigger";
+  const std::string l0_stop_opt = "level0_stop_writes_trigger";
+  const std::string soft_pending_opt = "soft_pending_compaction_bytes_limit";
+  const std::string hard_pending_opt = "hard_pending_compaction_bytes_limit";
+  const std::string output_level_limits_opt =
+      "max_compactions_per_output_level";
+  const std::string rate_limit_opt = kRateLimiterBytesPerSec;
 
   const int core_num;
   int max_thread = core_num;
   const int min_thread = 2;
   uint64_t max_memtable_size;
   const uint64_t min_memtable_size = 64 << 20;
+  // ARK adds immutable memtable slots up to this many memtables, and never
+  // goes below the configured max_write_buffer_number
+  int max_memtable_number = 8;
   uint64_t min_sstable_size = min_memtable_size;
   uint64_t max_sstable_size = max_memtable_size;
   int current_flush_threads_ = 1;
   int current_compaction_threads_ = 1;
+  // The RateLimiter budget ARK moves between the background jobs and the
+  // foreground, 0 without a RateLimiter. Flushes are IO_HIGH and served
+  // first, the compactions (IO_LOW) get what they leave of it.
+  uint64_t default_rate_limit_ = 0;
+  uint64_t rate_limit_ = 0;
 
   SystemScores ScoreTheSystem();
   void AdjustmentTuning(std::vector<ChangePoint>* change_list,
@@ -287,8 +600,35 @@ class DOTA_Tuner {
   TuningOP VoteForOP(SystemScores& current_score, ThreadStallLevels levels,
                      BatchSizeStallLevels stallLevels);
   void FillUpChangeList(std::vector<ChangePoint>* change_list, TuningOP op);
+  // `merge_value` 0 keeps the column family's min_write_buffer_number_to_merge
+  // for the L1 target size.
   void SetBatchSize(std::vector<ChangePoint>* change_list,
-                    uint64_t target_value, uint64_t sstable_value = 0);
+                    uint64_t target_value, uint64_t sstable_value = 0,
+                    const ColumnFamilyTuningState* cf = nullptr,
+                    int merge_value = 0);
+  // Emit the memtable, SST and L1 sizes of `cf` that differ from its current
+  // ones, and to *undo (if given) the points restoring them. Unlike
+  // SetBatchSize() the targets are taken as they are.
+  void SetColumnFamilySizes(std::vector<ChangePoint>* change_list,
+                            std::vector<ChangePoint>* undo,
+                            const ColumnFamilyTuningState& cf,
+                            uint64_t memtable_target, uint64_t sstable_target,
+                            int merge_target);
+  // Refresh cf_states_ and fold the worst column family into *score.
+  void ScoreColumnFamilies(SystemScores* score);
+  // Memory the memtables of all column families may use together, from the
+  // WriteBufferManager or db_write_buffer_size and from what the block
+  // caches leave of tuning_memory_budget. 0 if unlimited.
+  uint64_t MemtableBudget() const;
+  // Shrink the memtable targets until all their slots fit MemtableBudget().
+  // New slots go first, then memory of the column families without memtable
+  // pressure. A column family is not grown while the memtables still do not
+  // fit.
+  void ShareMemtableBudget(std::map<uint32_t, uint64_t>* memtable_targets,
+                           std::map<uint32_t, int>* slot_targets);
+  // capacity of the distinct block caches of all column families, refreshed
+  // with cf_states_
+  uint64_t block_cache_bytes_ = 0;
   void SetThreadNum(std::vector<ChangePoint>* change_list, int target_value);
   void FillUpChangeListArk(std::vector<ChangePoint>* change_list, TuningOP op);
   int CurrentFlushThreads() const { return current_flush_threads_; }
@@ -300,39 +640,75 @@ class FEAT_Tuner : public DOTA_Tuner {
  public:
   FEAT_Tuner(const Options opt, DBImpl* running_db, int64_t* last_report_op_ptr,
              std::atomic<int64_t>* total_ops_done_ptr, Env* env, int gap_sec,
-             bool triggerTEA, bool triggerFEA, bool triggerArk = false)
+             std::shared_ptr<TuningPolicy> policy)
       : DOTA_Tuner(opt, running_db, last_report_op_ptr, total_ops_done_ptr, env,
                    gap_sec),
-        TEA_enable(triggerTEA),
-        FEA_enable(triggerFEA),
-        ark_enable(triggerArk),
+        policy_(std::move(policy)),
         current_stage(kSlowStart) {
     flush_list_from_opt_ptr =
         this->running_db_->immutable_db_options().flush_stats;
 
-    std::cout << "Using FEAT tuner.\n FEA is "
-              << (FEA_enable ? "triggered" : "NOT triggered") << std::endl;
-    std::cout << "TEA is " << (TEA_enable ? "triggered" : "NOT triggered")
-              << std::endl;
-    std::cout << "ARK is " << (ark_enable ? "triggered" : "NOT triggered")
+    std::cout << "Using FEAT tuner with policy "
+              << (policy_ ? policy_->GetId() : std::string("none"))
               << std::endl;
   }
+  FEAT_Tuner(const Options opt, DBImpl* running_db, int64_t* last_report_op_ptr,
+             std::atomic<int64_t>* total_ops_done_ptr, Env* env, int gap_sec,
+             bool triggerTEA, bool triggerFEA, bool triggerArk = false)
+      : FEAT_Tuner(opt, running_db, last_report_op_ptr, total_ops_done_ptr,
+                   env, gap_sec,
+                   TuningPolicy::FromFlags(triggerTEA, triggerFEA,
+                                           triggerArk)) {}
+  // A tuner without a DB for ReplayRound(), configured like the traced one.
+  FEAT_Tuner(const TunerTraceHeader& header, Env* env,
+             std::shared_ptr<TuningPolicy> policy);
   void DetectTuningOperations(int secs_elapsed,
                               std::vector<ChangePoint>* change_list) override;
   ~FEAT_Tuner() override;
 
+  // Record every following round to `path`, see utilities/DOTA/tuner_trace.h.
+  Status StartTrace(Env* env, const std::string& path);
+  // Run the policy on the inputs of a traced round instead of the DB's state,
+  // and record the inputs and the decision into *output.
+  void ReplayRound(const TunerTraceRecord& input, TunerTraceRecord* output);
+  ArkCounters GetArkCounters() const;
+  // Load the state saved to `path` by an earlier tuner and save this one's
+  // there from now on, see DBOptions::tuner_state_file. The learned scores
+  // and counters are taken at once, the options the earlier tuner settled
+  // on are set in the first round. A missing file is not an error.
+  Status ResumeFrom(const std::string& path);
+  // Save the state now, e.g. when the DB closes. Nothing to do without
+  // ResumeFrom().
+  Status SaveState();
+
+  // Building blocks for the tuning policies.
+  // Scores the system for this round. Returns false when there is not enough
+  // flush history yet to decide anything.
+  bool ScoreRound();
   TuningOP TuneByTEA();
   TuningOP TuneByFEA();
+  TuningOP TuneByArk();
+  const TuningPolicy* policy() const { return policy_.get(); }
 
  private:
-  bool TEA_enable;
-  bool FEA_enable;
-  bool ark_enable;
+  std::shared_ptr<TuningPolicy> policy_;
+  std::shared_ptr<TunerTraceWriter> trace_writer_;
+  void TraceRound(int secs_elapsed, std::vector<ChangePoint>* change_list,
+                  TunerTraceRecord* record);
+  // the state is saved after a round that followed a change, and at least
+  // every kSaveStateRounds rounds
+  static constexpr uint64_t kSaveStateRounds = 60;
+  std::string state_file_;
+  std::shared_ptr<TunerState> resume_state_;
+  bool state_changed_ = false;
+  uint64_t rounds_since_save_ = 0;
+  // Bring the column families, by name, and the threads back to the saved
+  // state.
+  void ResumeRound(std::vector<ChangePoint>* change_list);
   SystemScores current_score_;
   SystemScores head_score_;
   std::deque<TuningOP> recent_ops;
   Stage current_stage;
-  double bandwidth_congestion_threshold = 0.7;
   double slow_down_threshold = 0.75;
   double RO_threshold = 0.8;
   double LO_threshold = 0.7;
@@ -360,7 +736,6 @@ class FEAT_Tuner : public DOTA_Tuner {
     return "unknown operation";
   }
   void CalculateAvgScore();
-  TuningOP TuneByArk();
 };
 inline const char* OpString(OpType v) {
   switch (v) {
@@ -11,6 +11,7 @@
 #include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -78,6 +79,10 @@ class ReporterAgent {
  protected:
   virtual void DetectAndTuning(int secs_elapsed);
   virtual Status ReportLine(int secs_elapsed, int total_ops_done_snapshot);
+  // Stop and join the reporting thread. Subclasses whose DetectAndTuning()
+  // uses their own members call this from their destructor, before those
+  // members are destroyed. Idempotent.
+  void StopReporting();
   Env* env_;
   std::unique_ptr<WritableFile> report_file_;
   std::atomic<int64_t> total_ops_done_;
@@ -133,6 +138,9 @@ class ReporterAgentWithSILK : public ReporterAgent {
   int FLAGS_value_size = 1000;
   int FLAGS_SILK_bandwidth_limitation = 350;
   DBImpl* running_db_;
+  // replaces FLAGS_SILK_bandwidth_limitation once learned, see
+  // DOTA_Tuner::bandwidth_
+  TuningBandwidth bandwidth_;
 
  public:
   ReporterAgentWithSILK(DBImpl* running_db, Env* env, const std::string& fname,
@@ -141,6 +149,63 @@ class ReporterAgentWithSILK : public ReporterAgent {
   Status ReportLine(int secs_elapsed, int total_ops_done_snapshot) override;
 };
 
+// Applies the tuners' change points on one long-lived thread, so that option
+// changes land in the order they were decided and no thread is created per
+// tuning round. Pending changes are coalesced per option key (the latest
+// value wins) into bounded sets, one for the DB options and one per column
+// family, so a round that tunes many column families is never cut short.
+// Every batch is applied with a single SetDBOptions() followed by one
+// SetOptions() per column family. The kRateLimiterBytesPerSec point is set
+// on the DB's RateLimiter instead.
+class TuningExecutor {
+ public:
+  explicit TuningExecutor(DBImpl* running_db,
+                          size_t max_pending_options = kMaxPendingOptions);
+  ~TuningExecutor();
+
+  TuningExecutor(const TuningExecutor&) = delete;
+  TuningExecutor& operator=(const TuningExecutor&) = delete;
+
+  // Queue the points for the executor thread. Returns the number of points
+  // dropped because the DB options or their column family already had
+  // max_pending_options option keys queued.
+  size_t Submit(const std::vector<ChangePoint>& points);
+
+  // True while changes are queued or being applied.
+  bool Busy() const;
+
+  // Wall time of the last applied batch and its status.
+  uint64_t LastApplyMicros() const {
+    return last_apply_micros_.load(std::memory_order_acquire);
+  }
+  uint64_t AppliedBatches() const {
+    return applied_batches_.load(std::memory_order_acquire);
+  }
+  Status LastApplyStatus() const;
+
+  // per column family, and for the DB options
+  static const size_t kMaxPendingOptions = 64;
+
+ private:
+  void Run();
+
+  DBImpl* running_db_;
+  const size_t max_pending_options_;
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::unordered_map<std::string, std::string> pending_db_options_;
+  // keyed by column family id
+  std::map<uint32_t, std::unordered_map<std::string, std::string>>
+      pending_cf_options_;
+  size_t num_pending_options_;
+  bool applying_;
+  bool stop_;
+  Status last_status_;
+  std::atomic<uint64_t> last_apply_micros_;
+  std::atomic<uint64_t> applied_batches_;
+  port::Thread thread_;
+};
+
 class ReporterAgentWithTuning : public ReporterAgent {
  private:
   std::vector<ChangePoint> tuning_points;
@@ -151,7 +216,16 @@ class ReporterAgentWithTuning : public ReporterAgent {
   uint64_t last_flush_thread_len;
   std::map<std::string, void*> string_to_attributes_map;
   std::unique_ptr<DOTA_Tuner> tuner;
-  bool applying_changes;
+  std::unique_ptr<TuningExecutor> executor_;
+  // Extra tuning rounds between two reports, woken by the DB's
+  // TuningTrigger (write stalls, memtable pressure, finished flushes).
+  void WaitForTuningEvents();
+  std::shared_ptr<TuningTrigger> trigger_;
+  std::atomic<bool> stop_events_;
+  uint64_t events_started_micros_;
+  // the tuner is used by the reporting thread and by the event thread
+  std::mutex tuning_mu_;
+  port::Thread event_thread_;
   static std::string DOTAHeader() {
     return "secs_elapsed,interval_qps,memtable_mb,sstable_mb,flush_threads,compaction_threads";
   }
@@ -176,6 +250,7 @@ class ReporterAgentWithTuning : public ReporterAgent {
                           uint64_t report_interval_secs,
                           uint64_t dota_tuning_gap_secs = 1,
                           bool report_total_threads_only = false);
+  ~ReporterAgentWithTuning() override;
   DOTA_Tuner* GetTuner() { return tuner.get(); }
   void ApplyChangePointsInstantly(std::vector<ChangePoint>* points);
 
@@ -190,6 +265,7 @@ class ReporterAgentWithTuning : public ReporterAgent {
 
   Status ReportLine(int secs_elapsed, int total_ops_done_snapshot) override;
   void UseFEATTuner(bool TEA_enable, bool FEA_enable, bool ark_enable = false);
+  void UseTuningPolicy(std::shared_ptr<TuningPolicy> policy);
   //  void print_useless_thing(int secs_elapsed);
   void DetectAndTuning(int secs_elapsed) override;
   enum CongestionStatus {
@@ -262,6 +262,10 @@ class StackableDB : public DB {
     return db_->GetAggregatedIntProperty(property, value);
   }
 
+  virtual Status GetTuningSnapshot(TuningSnapshot* snapshot) override {
+    return db_->GetTuningSnapshot(snapshot);
+  }
+
   using DB::GetApproximateSizes;
   virtual Status GetApproximateSizes(const SizeApproximationOptions& options,
                                      ColumnFamilyHandle* column_family,
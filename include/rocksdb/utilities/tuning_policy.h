@@ -0,0 +1,56 @@
+// Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/customizable.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class FEAT_Tuner;
+struct ChangePoint;
+
+// TuningPolicy decides, once per tuning round, which options to change. The
+// tuner owns the scoring and every piece of history (score windows, pressure
+// counters, current thread split); the policy only picks the decision
+// procedure, so one policy object may be shared by several tuners and DBs.
+//
+// Built-in policies:
+//   "ARK"  - flush/compaction thread split, memtable and SST size (ARK)
+//   "TEA"  - total background threads only (TEA)
+//   "FEA"  - memtable size only (FEA)
+//   "FEAT" - TEA for the threads and FEA for the memtable size
+//   "DOTA" - the original DOTA stall-area tuning
+//
+// A policy is picked from an options string, e.g. "tuning_policy=ARK" in
+// DBOptions, or created directly with CreateFromString(). Applications can
+// register their own policies with the ObjectRegistry.
+class TuningPolicy : public Customizable {
+ public:
+  ~TuningPolicy() override {}
+  static const char* Type() { return "TuningPolicy"; }
+  static Status CreateFromString(const ConfigOptions& config_options,
+                                 const std::string& value,
+                                 std::shared_ptr<TuningPolicy>* result);
+
+  // Returns the policy the FEAT_Tuner booleans used to select, or nullptr
+  // when none of them is set.
+  static std::shared_ptr<TuningPolicy> FromFlags(bool tea_enable,
+                                                 bool fea_enable,
+                                                 bool ark_enable);
+
+  // Append the changes for this round to *change_list. Called on the tuning
+  // thread; `tuner` has not scored the round yet.
+  virtual void DetectTuningOperations(
+      FEAT_Tuner* tuner, int secs_elapsed,
+      std::vector<ChangePoint>* change_list) const = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -292,6 +292,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, max_write_buffer_number),
           OptionType::kInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"min_write_buffer_number_to_merge",
+         {offsetof(struct MutableCFOptions, min_write_buffer_number_to_merge),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"source_compaction_factor",
          {0, OptionType::kInt, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kMutable}},
@@ -356,6 +360,12 @@ static std::unordered_map<std::string, OptionTypeInfo>
                       max_bytes_for_level_multiplier_additional),
              OptionVerificationType::kNormal, OptionTypeFlags::kMutable,
              {0, OptionType::kInt})},
+        {"max_compactions_per_output_level",
+         OptionTypeInfo::Vector<int>(
+             offsetof(struct MutableCFOptions,
+                      max_compactions_per_output_level),
+             OptionVerificationType::kNormal, OptionTypeFlags::kMutable,
+             {0, OptionType::kInt})},
         {"max_sequential_skip_in_iterations",
          {offsetof(struct MutableCFOptions, max_sequential_skip_in_iterations),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -576,10 +586,6 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    max_write_buffer_size_to_maintain),
           OptionType::kInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
-        {"min_write_buffer_number_to_merge",
-         {offsetof(struct ImmutableCFOptions, min_write_buffer_number_to_merge),
-          OptionType::kInt, OptionVerificationType::kNormal,
-          OptionTypeFlags::kNone, 0}},
         {"num_levels",
          {offsetof(struct ImmutableCFOptions, num_levels), OptionType::kInt,
           OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
@@ -877,8 +883,6 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
       merge_operator(cf_options.merge_operator),
       compaction_filter(cf_options.compaction_filter),
       compaction_filter_factory(cf_options.compaction_filter_factory),
-      min_write_buffer_number_to_merge(
-          cf_options.min_write_buffer_number_to_merge),
       max_write_buffer_number_to_maintain(
           cf_options.max_write_buffer_number_to_maintain),
       max_write_buffer_size_to_maintain(
@@ -988,6 +992,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  write_buffer_size);
   ROCKS_LOG_INFO(log, "                  max_write_buffer_number: %d",
                  max_write_buffer_number);
+  ROCKS_LOG_INFO(log, "         min_write_buffer_number_to_merge: %d",
+                 min_write_buffer_number_to_merge);
   ROCKS_LOG_INFO(log,
                  "                         arena_block_size: %" ROCKSDB_PRIszt,
                  arena_block_size);
@@ -1048,6 +1054,16 @@ void MutableCFOptions::Dump(Logger* log) const {
 
   ROCKS_LOG_INFO(log, "max_bytes_for_level_multiplier_additional: %s",
                  result.c_str());
+  result.clear();
+  for (const auto m : max_compactions_per_output_level) {
+    snprintf(buf, sizeof(buf), "%d, ", m);
+    result += buf;
+  }
+  if (result.size() >= 2) {
+    result.resize(result.size() - 2);
+  }
+  ROCKS_LOG_INFO(log, "         max_compactions_per_output_level: %s",
+                 result.c_str());
   ROCKS_LOG_INFO(log, "        max_sequential_skip_in_iterations: %" PRIu64,
                  max_sequential_skip_in_iterations);
   ROCKS_LOG_INFO(log, "         check_flush_compaction_key_order: %d",
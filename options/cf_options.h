@@ -38,8 +38,6 @@ struct ImmutableCFOptions {
 
   std::shared_ptr<CompactionFilterFactory> compaction_filter_factory;
 
-  int min_write_buffer_number_to_merge;
-
   int max_write_buffer_number_to_maintain;
 
   int64_t max_write_buffer_size_to_maintain;
@@ -106,6 +104,8 @@ struct MutableCFOptions {
   explicit MutableCFOptions(const ColumnFamilyOptions& options)
       : write_buffer_size(options.write_buffer_size),
         max_write_buffer_number(options.max_write_buffer_number),
+        min_write_buffer_number_to_merge(
+            options.min_write_buffer_number_to_merge),
         arena_block_size(options.arena_block_size),
         memtable_prefix_bloom_size_ratio(
             options.memtable_prefix_bloom_size_ratio),
@@ -126,6 +126,8 @@ struct MutableCFOptions {
         level0_slowdown_writes_trigger(options.level0_slowdown_writes_trigger),
         level0_stop_writes_trigger(options.level0_stop_writes_trigger),
         max_compaction_bytes(options.max_compaction_bytes),
+        max_compactions_per_output_level(
+            options.max_compactions_per_output_level),
         target_file_size_base(options.target_file_size_base),
         target_file_size_multiplier(options.target_file_size_multiplier),
         max_bytes_for_level_base(options.max_bytes_for_level_base),
@@ -173,6 +175,7 @@ struct MutableCFOptions {
   MutableCFOptions()
       : write_buffer_size(0),
         max_write_buffer_number(0),
+        min_write_buffer_number_to_merge(0),
         arena_block_size(0),
         memtable_prefix_bloom_size_ratio(0),
         memtable_whole_key_filtering(false),
@@ -224,6 +227,16 @@ struct MutableCFOptions {
     RefreshDerivedOptions(ioptions.num_levels, ioptions.compaction_style);
   }
 
+  // 0 means no limit
+  int MaxCompactionsForOutputLevel(int level) const {
+    if (level < 0 ||
+        level >= static_cast<int>(max_compactions_per_output_level.size())) {
+      return 0;
+    }
+    const int limit = max_compactions_per_output_level[level];
+    return limit > 0 ? limit : 0;
+  }
+
   int MaxBytesMultiplerAdditional(int level) const {
     if (level >=
         static_cast<int>(max_bytes_for_level_multiplier_additional.size())) {
@@ -237,6 +250,7 @@ struct MutableCFOptions {
   // Memtable related options
   size_t write_buffer_size;
   int max_write_buffer_number;
+  int min_write_buffer_number_to_merge;
   size_t arena_block_size;
   double memtable_prefix_bloom_size_ratio;
   bool memtable_whole_key_filtering;
@@ -269,6 +283,7 @@ struct MutableCFOptions {
   int level0_slowdown_writes_trigger;
   int level0_stop_writes_trigger;
   uint64_t max_compaction_bytes;
+  std::vector<int> max_compactions_per_output_level;
   uint64_t target_file_size_base;
   int target_file_size_multiplier;
   uint64_t max_bytes_for_level_base;
@@ -34,6 +34,7 @@
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/options_type.h"
+#include "rocksdb/utilities/tuning_policy.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/flush_block_policy.h"
 #include "table/mock_table.h"
@@ -2000,6 +2001,31 @@ TEST_F(LoadCustomizableTest, LoadMemTableRepFactoryTest) {
   }
 }
 
+TEST_F(LoadCustomizableTest, LoadTuningPolicyTest) {
+  std::unordered_set<std::string> expected = {"ARK", "TEA", "FEA", "FEAT",
+                                              "DOTA"};
+  std::vector<std::string> failures;
+  std::shared_ptr<TuningPolicy> policy;
+  ASSERT_OK(TestExpectedBuiltins<TuningPolicy>("Mock", expected, &policy,
+                                               &failures));
+  ASSERT_TRUE(failures.empty());
+
+  ASSERT_EQ(TuningPolicy::FromFlags(false, false, false), nullptr);
+  ASSERT_STREQ(TuningPolicy::FromFlags(true, true, true)->Name(), "ARK");
+  ASSERT_STREQ(TuningPolicy::FromFlags(true, true, false)->Name(), "FEAT");
+  ASSERT_STREQ(TuningPolicy::FromFlags(false, true, false)->Name(), "FEA");
+
+#ifndef ROCKSDB_LITE
+  DBOptions db_opts;
+  ASSERT_OK(GetDBOptionsFromString(config_options_, DBOptions(),
+                                   "tuning_policy=ARK", &db_opts));
+  ASSERT_NE(db_opts.tuning_policy, nullptr);
+  ASSERT_STREQ(db_opts.tuning_policy->Name(), "ARK");
+  ASSERT_NOK(GetDBOptionsFromString(config_options_, DBOptions(),
+                                    "tuning_policy=Unknown", &db_opts));
+#endif  // ROCKSDB_LITE
+}
+
 TEST_F(LoadCustomizableTest, LoadMergeOperatorTest) {
   std::shared_ptr<MergeOperator> result;
   std::vector<std::string> failed;
@@ -21,8 +21,10 @@
 #include "rocksdb/statistics.h"
 #include "rocksdb/system_clock.h"
 #include "rocksdb/utilities/options_type.h"
+#include "rocksdb/utilities/tuning_policy.h"
 #include "rocksdb/wal_filter.h"
 #include "util/string_util.h"
+#include "utilities/counted_fs.h"
 
 namespace ROCKSDB_NAMESPACE {
 #ifndef ROCKSDB_LITE
@@ -35,6 +37,11 @@ static std::unordered_map<std::string, WALRecoveryMode>
         {"kSkipAnyCorruptedRecords",
          WALRecoveryMode::kSkipAnyCorruptedRecords}};
 
+static std::unordered_map<std::string, TuningObjective>
+    tuning_objective_string_map = {
+        {"kThroughput", TuningObjective::kThroughput},
+        {"kLatency", TuningObjective::kLatency}};
+
 static std::unordered_map<std::string, DBOptions::AccessHint>
     access_hint_string_map = {{"NONE", DBOptions::AccessHint::NONE},
                               {"NORMAL", DBOptions::AccessHint::NORMAL},
@@ -558,6 +565,43 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, enforce_single_del_contracts),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"shrink_background_threads",
+         {offsetof(struct ImmutableDBOptions, shrink_background_threads),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"tuning_policy",
+         OptionTypeInfo::AsCustomSharedPtr<TuningPolicy>(
+             offsetof(struct ImmutableDBOptions, tuning_policy),
+             OptionVerificationType::kByNameAllowFromNull,
+             OptionTypeFlags::kAllowNull)},
+        {"auto_tune_period_sec",
+         {offsetof(struct ImmutableDBOptions, auto_tune_period_sec),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"auto_tune_gap_sec",
+         {offsetof(struct ImmutableDBOptions, auto_tune_gap_sec),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"tuning_trigger_interval_ms",
+         {offsetof(struct ImmutableDBOptions, tuning_trigger_interval_ms),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"tuner_trace_file",
+         {offsetof(struct ImmutableDBOptions, tuner_trace_file),
+          OptionType::kString, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"tuner_state_file",
+         {offsetof(struct ImmutableDBOptions, tuner_state_file),
+          OptionType::kString, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"tuning_objective",
+         OptionTypeInfo::Enum<TuningObjective>(
+             offsetof(struct ImmutableDBOptions, tuning_objective),
+             &tuning_objective_string_map)},
+        {"tuning_memory_budget",
+         {offsetof(struct ImmutableDBOptions, tuning_memory_budget),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kDBOptionsName = "DBOptions";
@@ -760,14 +804,34 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       compaction_service(options.compaction_service),
       enforce_single_del_contracts(options.enforce_single_del_contracts),
       core_number(options.core_number),
-      max_memtable_size(options.max_memtable_size){
+      max_memtable_size(options.max_memtable_size),
+      shrink_background_threads(options.shrink_background_threads),
+      tuning_policy(options.tuning_policy),
+      auto_tune_period_sec(options.auto_tune_period_sec),
+      auto_tune_gap_sec(options.auto_tune_gap_sec),
+      tuning_trigger_interval_ms(options.tuning_trigger_interval_ms),
+      tuner_trace_file(options.tuner_trace_file),
+      tuner_state_file(options.tuner_state_file),
+      tuning_objective(options.tuning_objective),
+      tuning_memory_budget(options.tuning_memory_budget) {
   fs = env->GetFileSystem();
   clock = env->GetSystemClock().get();
   logger = info_log.get();
   stats = statistics.get();
 
-  job_stats = std::make_shared<std::vector<QuicksandMetrics>>();
-  flush_stats = std::make_shared<std::vector<FlushMetrics>>();
+  job_stats = std::make_shared<MetricsRingBuffer<QuicksandMetrics>>();
+  flush_stats = std::make_shared<MetricsRingBuffer<FlushMetrics>>();
+  if (tuning_trigger_interval_ms > 0) {
+    tuning_trigger = std::make_shared<TuningTrigger>(
+        uint64_t{tuning_trigger_interval_ms} * 1000);
+  }
+  if (tuning_objective == TuningObjective::kLatency) {
+    tuning_latency = std::make_shared<TuningLatency>();
+  }
+  if (tuning_policy != nullptr) {
+    tuning_fs = std::make_shared<CountedFileSystem>(fs);
+    fs = tuning_fs;
+  }
 }
 
 void ImmutableDBOptions::Dump(Logger* log) const {
@@ -935,6 +999,25 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    db_host_id.c_str());
   ROCKS_LOG_HEADER(log, "            Options.enforce_single_del_contracts: %s",
                    enforce_single_del_contracts ? "true" : "false");
+  ROCKS_LOG_HEADER(log, "               Options.shrink_background_threads: %s",
+                   shrink_background_threads ? "true" : "false");
+  ROCKS_LOG_HEADER(log, "                           Options.tuning_policy: %s",
+                   tuning_policy ? tuning_policy->GetId().c_str() : "None");
+  ROCKS_LOG_HEADER(log, "                    Options.auto_tune_period_sec: %u",
+                   auto_tune_period_sec);
+  ROCKS_LOG_HEADER(log, "                       Options.auto_tune_gap_sec: %u",
+                   auto_tune_gap_sec);
+  ROCKS_LOG_HEADER(log, "              Options.tuning_trigger_interval_ms: %u",
+                   tuning_trigger_interval_ms);
+  ROCKS_LOG_HEADER(log, "                        Options.tuner_trace_file: %s",
+                   tuner_trace_file.c_str());
+  ROCKS_LOG_HEADER(log, "                        Options.tuner_state_file: %s",
+                   tuner_state_file.c_str());
+  ROCKS_LOG_HEADER(log, "                        Options.tuning_objective: %d",
+                   static_cast<int>(tuning_objective));
+  ROCKS_LOG_HEADER(log,
+                   "                    Options.tuning_memory_budget: %" PRIu64,
+                   tuning_memory_budget);
 }
 
 bool ImmutableDBOptions::IsWalDirSameAsDBPath() const {
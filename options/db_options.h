@@ -8,9 +8,14 @@
 #include <string>
 #include <vector>
 
+#include "rocksdb/compaction_job_stats.h"
 #include "rocksdb/options.h"
+#include "util/metrics_ring_buffer.h"
+#include "util/tuning_latency.h"
+#include "util/tuning_trigger.h"
 
 namespace ROCKSDB_NAMESPACE {
+class CountedFileSystem;
 class SystemClock;
 
 struct ImmutableDBOptions {
@@ -109,8 +114,28 @@ struct ImmutableDBOptions {
 
   uint64_t core_number;
   uint64_t max_memtable_size;
-  std::shared_ptr<std::vector<QuicksandMetrics>> job_stats;
-  std::shared_ptr<std::vector<FlushMetrics>> flush_stats;
+  bool shrink_background_threads;
+  std::shared_ptr<TuningPolicy> tuning_policy;
+  unsigned int auto_tune_period_sec;
+  unsigned int auto_tune_gap_sec;
+  unsigned int tuning_trigger_interval_ms;
+  std::string tuner_trace_file;
+  std::string tuner_state_file;
+  TuningObjective tuning_objective;
+  uint64_t tuning_memory_budget;
+  // Per-job metrics for the DOTA tuners. Fixed-size lock-free rings, written
+  // by flush/compaction jobs and consumed by the tuner with its own cursor.
+  std::shared_ptr<MetricsRingBuffer<QuicksandMetrics>> job_stats;
+  std::shared_ptr<MetricsRingBuffer<FlushMetrics>> flush_stats;
+  // Wakes the tuner on write stalls, memtable pressure and finished flushes,
+  // nullptr when tuning_trigger_interval_ms is 0.
+  std::shared_ptr<TuningTrigger> tuning_trigger;
+  // Latency of the foreground writes and reads for the tuner, nullptr unless
+  // tuning_objective is kLatency.
+  std::shared_ptr<TuningLatency> tuning_latency;
+  // Wraps fs to count the bytes the DB writes and reads, from which the tuner
+  // learns the device bandwidth. nullptr unless tuning_policy is set.
+  std::shared_ptr<CountedFileSystem> tuning_fs;
 
   bool IsWalDirSameAsDBPath() const;
   bool IsWalDirSameAsDBPath(const std::string& path) const;
@@ -71,6 +71,8 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       max_bytes_for_level_multiplier_additional(
           options.max_bytes_for_level_multiplier_additional),
       max_compaction_bytes(options.max_compaction_bytes),
+      max_compactions_per_output_level(
+          options.max_compactions_per_output_level),
       soft_pending_compaction_bytes_limit(
           options.soft_pending_compaction_bytes_limit),
       hard_pending_compaction_bytes_limit(
@@ -280,6 +282,12 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(
         log, "                   Options.max_compaction_bytes: %" PRIu64,
         max_compaction_bytes);
+    for (size_t i = 0; i < max_compactions_per_output_level.size(); i++) {
+      ROCKS_LOG_HEADER(
+          log, "Options.max_compactions_per_output_level[%" ROCKSDB_PRIszt
+               "]: %d",
+          i, max_compactions_per_output_level[i]);
+    }
     ROCKS_LOG_HEADER(
         log,
         "                       Options.arena_block_size: %" ROCKSDB_PRIszt,
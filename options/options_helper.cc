@@ -186,6 +186,17 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.lowest_used_cache_tier = immutable_db_options.lowest_used_cache_tier;
   options.enforce_single_del_contracts =
       immutable_db_options.enforce_single_del_contracts;
+  options.shrink_background_threads =
+      immutable_db_options.shrink_background_threads;
+  options.tuning_policy = immutable_db_options.tuning_policy;
+  options.auto_tune_period_sec = immutable_db_options.auto_tune_period_sec;
+  options.auto_tune_gap_sec = immutable_db_options.auto_tune_gap_sec;
+  options.tuning_trigger_interval_ms =
+      immutable_db_options.tuning_trigger_interval_ms;
+  options.tuner_trace_file = immutable_db_options.tuner_trace_file;
+  options.tuner_state_file = immutable_db_options.tuner_state_file;
+  options.tuning_objective = immutable_db_options.tuning_objective;
+  options.tuning_memory_budget = immutable_db_options.tuning_memory_budget;
   return options;
 }
 
@@ -204,6 +215,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
   // Memtable related options
   cf_opts->write_buffer_size = moptions.write_buffer_size;
   cf_opts->max_write_buffer_number = moptions.max_write_buffer_number;
+  cf_opts->min_write_buffer_number_to_merge =
+      moptions.min_write_buffer_number_to_merge;
   cf_opts->arena_block_size = moptions.arena_block_size;
   cf_opts->memtable_prefix_bloom_size_ratio =
       moptions.memtable_prefix_bloom_size_ratio;
@@ -229,6 +242,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.level0_slowdown_writes_trigger;
   cf_opts->level0_stop_writes_trigger = moptions.level0_stop_writes_trigger;
   cf_opts->max_compaction_bytes = moptions.max_compaction_bytes;
+  cf_opts->max_compactions_per_output_level =
+      moptions.max_compactions_per_output_level;
   cf_opts->target_file_size_base = moptions.target_file_size_base;
   cf_opts->target_file_size_multiplier = moptions.target_file_size_multiplier;
   cf_opts->max_bytes_for_level_base = moptions.max_bytes_for_level_base;
@@ -286,8 +301,6 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
   cf_opts->merge_operator = ioptions.merge_operator;
   cf_opts->compaction_filter = ioptions.compaction_filter;
   cf_opts->compaction_filter_factory = ioptions.compaction_filter_factory;
-  cf_opts->min_write_buffer_number_to_merge =
-      ioptions.min_write_buffer_number_to_merge;
   cf_opts->max_write_buffer_number_to_maintain =
       ioptions.max_write_buffer_number_to_maintain;
   cf_opts->max_write_buffer_size_to_maintain =
@@ -250,6 +250,10 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
        sizeof(FileTypeSet)},
       {offsetof(struct DBOptions, compaction_service),
        sizeof(std::shared_ptr<CompactionService>)},
+      {offsetof(struct DBOptions, tuning_policy),
+       sizeof(std::shared_ptr<TuningPolicy>)},
+      {offsetof(struct DBOptions, tuner_trace_file), sizeof(std::string)},
+      {offsetof(struct DBOptions, tuner_state_file), sizeof(std::string)},
   };
 
   char* options_ptr = new char[sizeof(DBOptions)];
@@ -359,7 +363,13 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "db_host_id=hostname;"
                              "lowest_used_cache_tier=kNonVolatileBlockTier;"
                              "allow_data_in_errors=false;"
-                             "enforce_single_del_contracts=false;",
+                             "enforce_single_del_contracts=false;"
+                             "shrink_background_threads=false;"
+                             "auto_tune_period_sec=0;"
+                             "auto_tune_gap_sec=1;"
+                             "tuning_trigger_interval_ms=200;"
+                             "tuning_objective=kLatency;"
+                             "tuning_memory_budget=4294967296;",
                              new_options));
 
   ASSERT_EQ(unset_bytes_base, NumUnsetBytes(new_options_ptr, sizeof(DBOptions),
@@ -395,6 +405,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       {offsetof(struct ColumnFamilyOptions,
                 max_bytes_for_level_multiplier_additional),
        sizeof(std::vector<int>)},
+      {offsetof(struct ColumnFamilyOptions, max_compactions_per_output_level),
+       sizeof(std::vector<int>)},
       {offsetof(struct ColumnFamilyOptions, memtable_factory),
        sizeof(std::shared_ptr<MemTableRepFactory>)},
       {offsetof(struct ColumnFamilyOptions,
@@ -555,6 +567,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
   const OffsetGap kMutableCFOptionsExcluded = {
       {offsetof(struct MutableCFOptions, prefix_extractor),
        sizeof(std::shared_ptr<const SliceTransform>)},
+      {offsetof(struct MutableCFOptions, max_compactions_per_output_level),
+       sizeof(std::vector<int>)},
       {offsetof(struct MutableCFOptions,
                 max_bytes_for_level_multiplier_additional),
        sizeof(std::vector<int>)},
@@ -151,6 +151,7 @@ LIB_SOURCES =                                                   \
   ycsbcore/basic_db.cc                                          		\
   ycsbcore/core_workload.cc                                    		 	\
   ycsbcore/db_factory.cc                                        		\
+  ycsbcore/load_profile.cc                                      		\
   ycsbcore/measurements.cc                                      		\
   ycsbcore/ycsbc.cc                                             		\
   options/cf_options.cc                                         \
@@ -277,6 +278,9 @@ LIB_SOURCES =                                                   \
   utilities/leveldb_options/leveldb_options.cc                  \
   utilities/DOTA/report_agent.cc								\
   utilities/DOTA/DOTA_tuner.cc                      			\
+  utilities/DOTA/auto_tuner.cc                                  \
+  utilities/DOTA/tuning_policy.cc                               \
+  utilities/DOTA/tuner_trace.cc                                 \
   utilities/memory/memory_util.cc                               \
   utilities/merge_operators.cc                                  \
   utilities/merge_operators/max.cc                              \
@@ -350,6 +354,7 @@ TOOL_LIB_SOURCES =                                              \
   tools/ldb_cmd.cc                                              \
   tools/ldb_tool.cc                                             \
   tools/sst_dump_tool.cc                                        \
+  tools/tuner_replay_tool.cc                                    \
   utilities/blob_db/blob_dump_tool.cc                           \
 
 ANALYZER_LIB_SOURCES =                                          \
@@ -414,6 +419,7 @@ TOOLS_MAIN_SOURCES =                                                    \
   tools/dump/rocksdb_undump.cc                                          \
   tools/trace_analyzer.cc                                               \
   tools/io_tracer_parser_tool.cc                                        \
+  tools/tuner_replay.cc                                                 \
 
 BENCH_MAIN_SOURCES =                                                    \
   cache/cache_bench.cc                                                  \
@@ -581,6 +587,7 @@ TEST_MAIN_SOURCES =                                                     \
   util/file_reader_writer_test.cc                                       \
   util/hash_test.cc                                                     \
   util/heap_test.cc                                                     \
+  util/metrics_ring_buffer_test.cc                                      \
   util/random_test.cc                                                   \
   util/rate_limiter_test.cc                                             \
   util/repeatable_thread_test.cc                                        \
@@ -591,6 +598,10 @@ TEST_MAIN_SOURCES =                                                     \
   util/timer_test.cc                                                    \
   util/thread_list_test.cc                                              \
   util/thread_local_test.cc                                             \
+  util/tuning_bandwidth_test.cc                                         \
+  util/tuning_latency_test.cc                                           \
+  util/tuning_trigger_test.cc                                           \
+  util/tuning_workload_test.cc                                          \
   util/work_queue_test.cc                                               \
   utilities/agg_merge/agg_merge_test.cc                                 \
   utilities/backup/backup_engine_test.cc                                \
@@ -600,6 +611,8 @@ TEST_MAIN_SOURCES =                                                     \
   utilities/cassandra/cassandra_row_merge_test.cc                       \
   utilities/cassandra/cassandra_serialize_test.cc                       \
   utilities/checkpoint/checkpoint_test.cc                               \
+  utilities/DOTA/DOTA_tuner_test.cc                                     \
+  utilities/DOTA/tuner_trace_test.cc                                    \
   utilities/env_timed_test.cc                                           \
   utilities/memory/memory_test.cc                                       \
   utilities/merge_operators/string_append/stringappend_test.cc          \
@@ -622,6 +635,7 @@ TEST_MAIN_SOURCES =                                                     \
   utilities/ttl/ttl_test.cc                                             \
   utilities/util_merge_operators_test.cc                                \
   utilities/write_batch_with_index/write_batch_with_index_test.cc       \
+  ycsbcore/latency_histogram_test.cc                                    \
 
 TEST_MAIN_SOURCES_C = \
   db/c_test.c                                                           \
@@ -28,6 +28,7 @@
 #endif
 #include <atomic>
 #include <cinttypes>
+#include <cmath>
 #include <condition_variable>
 #include <cstddef>
 #include <iostream>
@@ -74,6 +75,7 @@
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/transaction_db.h"
 #include "rocksdb/utilities/report_agent.h"
+#include "rocksdb/utilities/tuning_policy.h"
 #include "rocksdb/write_batch.h"
 #include "test_util/testutil.h"
 #include "test_util/transaction_test_util.h"
@@ -83,6 +85,7 @@
 #include "util/crc32c.h"
 #include "util/file_checksum_helper.h"
 #include "util/gflags_compat.h"
+#include "util/hash.h"
 #include "util/mutexlock.h"
 #include "util/random.h"
 #include "util/stderr_logger.h"
@@ -99,6 +102,7 @@
 #include "ycsbcore/core_workload.h"
 #include "ycsbcore/countdown_latch.h"
 #include "ycsbcore/db_factory.h"
+#include "ycsbcore/load_profile.h"
 #include "ycsbcore/measurements.h"
 #include "ycsbcore/timer.h"
 #include "ycsbcore/utils.h"
@@ -774,7 +778,32 @@ DEFINE_string(db, "", "Use the db with the following name.");
 // for FEAT
 DEFINE_int64(load_duration, 0, "The loading duration of YCSB");
 DEFINE_string(ycsb_workload, "", "The workload of YCSB");
-DEFINE_int64(ycsb_request_speed, 100, "The request speed of YCSB, in MB/s");
+DEFINE_int64(ycsb_request_speed, 100,
+             "The request speed of an open-loop YCSB, over all threads, in "
+             "MB/s. A request counts as key_size + value_size bytes.");
+DEFINE_int64(ycsb_request_ops, 0,
+             "The request rate of an open-loop YCSB, over all threads, in "
+             "ops/s. 0 takes ycsb_request_speed instead.");
+DEFINE_string(ycsb_arrival, "closed",
+              "How YCSB issues its requests. closed: each thread issues the "
+              "next request once the previous one returned. constant or "
+              "poisson: open loop, the requests arrive on a schedule, evenly "
+              "spaced or as a Poisson process, and their latencies count from "
+              "the scheduled start. Open loop turns on --histogram.");
+DEFINE_bool(ycsb_sort_batch, false,
+            "Sort the keys of every batch of the YCSB load phase (batch_size "
+            "keys) before writing it.");
+DEFINE_bool(ycsb_native_scan, false,
+            "Run YCSB scans on one iterator per DB and thread, refreshed "
+            "before every seek and bounded by the scan length, with "
+            "readahead_size and async_io. Scans and reads use the values in "
+            "place instead of copying them.");
+DEFINE_string(ycsb_load_profile, "",
+              "A CSV file of YCSB run phases, see ycsbcore/load_profile.h. "
+              "Each phase sets the request rate, paced as ycsb_arrival says "
+              "(evenly spaced if it is closed), the operation mix and the key "
+              "distribution, without restarting the threads. A phase with a "
+              "request rate turns on --histogram.");
 DEFINE_int64(load_num, 100000, "Num of operations in loading phrase");
 DEFINE_int64(running_num, 100000, "Num of operations in running phrase");
 DEFINE_int64(core_num, 20, "The limit of thread number");
@@ -791,11 +820,35 @@ DEFINE_double(idle_rate, 1.25,
 DEFINE_double(FEA_gap_threshold, 1.5,
               "The negative feedback loop's threshold");
 DEFINE_double(TEA_slow_flush, 0.5, "The negative feedback loop's threshold");
+DEFINE_int32(ARK_max_stall_limit_ratio, 4,
+             "ARK raises the write stall limits up to this many times the "
+             "configured ones");
 DEFINE_double(DOTA_tuning_gap, 1.0, "Tuning gap of the DOTA agent, in secs ");
 DEFINE_int64(random_fill_average, 150,
              "average inputs rate of background write operations");
 DEFINE_bool(detailed_running_stats, false,
             "Whether record more detailed information in report agent");
+DEFINE_bool(shrink_background_threads,
+            ROCKSDB_NAMESPACE::Options().shrink_background_threads,
+            "Let the tuners shrink the HIGH/LOW thread pools when they lower "
+            "max_background_flushes/compactions/jobs");
+DEFINE_string(tuning_policy, "",
+              "Tuning policy to run, as an options string (e.g. ARK, TEA, FEA, "
+              "FEAT, DOTA). Overrides the DOTA/ARK/TEA/FEA flags.");
+DEFINE_string(tuner_trace_file, "",
+              "Record every tuning round to this file, for tuner_replay.");
+DEFINE_string(tuner_state_file, "",
+              "Save the tuner's learned state to this file and resume from "
+              "it when the DB is opened again.");
+DEFINE_string(tuning_objective, "throughput",
+              "What the tuner optimizes for: throughput or latency (the p99 "
+              "latency of writes and reads).");
+DEFINE_uint64(tuning_memory_budget, 0,
+              "Bytes the memtables and block caches of a tuned DB may take "
+              "together, 0 for no budget.");
+DEFINE_uint32(tuning_trigger_interval_ms, 200,
+              "Milliseconds between two tuning rounds woken up by write "
+              "stalls, memtable pressure or flushes, 0 for none.");
 
 
 
@@ -1805,6 +1858,31 @@ enum DistributionType : unsigned char {
 
 static enum DistributionType FLAGS_value_size_distribution_type_e = kFixed;
 
+enum YCSBArrival : unsigned char {
+  kClosedLoop = 0,
+  kConstantArrival,
+  kPoissonArrival
+};
+
+static enum YCSBArrival FLAGS_ycsb_arrival_e = kClosedLoop;
+
+// --ycsb_load_profile, parsed once before the threads start
+static ycsbc::LoadProfile FLAGS_ycsb_load_profile_v;
+
+static enum YCSBArrival StringToYCSBArrival(const char* arrival) {
+  assert(arrival);
+
+  if (!strcasecmp(arrival, "closed"))
+    return kClosedLoop;
+  else if (!strcasecmp(arrival, "constant"))
+    return kConstantArrival;
+  else if (!strcasecmp(arrival, "poisson"))
+    return kPoissonArrival;
+
+  fprintf(stdout, "Cannot parse ycsb arrival '%s'\n", arrival);
+  exit(1);
+}
+
 static enum DistributionType StringToDistributionType(const char* ctype) {
   assert(ctype);
 
@@ -2212,6 +2290,10 @@ class Stats {
     last_op_finish_ = clock_->NowMicros();
   }
 
+  // The latency of the next op counts from `micros`, its scheduled start
+  // under an open-loop load.
+  void SetLastOpTime(uint64_t micros) { last_op_finish_ = micros; }
+
   void FinishedOps(DBWithColumnFamilies* db_with_cfh, DB* db, int64_t num_ops,
                    enum OperationType op_type = kOthers) {
     if (reporter_agent_) {
@@ -2627,6 +2709,43 @@ class Duration {
   uint64_t start_at_;
 };
 
+// The scheduled start times of an open-loop client. The requests arrive at
+// `ops_per_sec` on average, evenly spaced or as a Poisson process, whether
+// the previous ones returned or not. A request that starts late keeps its
+// scheduled start, so the time it queued behind a stall counts into its
+// latency instead of being hidden (coordinated omission).
+class ArrivalSchedule {
+ public:
+  ArrivalSchedule(YCSBArrival arrival, double ops_per_sec, uint64_t seed)
+      : arrival_(arrival),
+        interval_micros_(1000000.0 / ops_per_sec),
+        rand_(seed),
+        next_micros_(static_cast<double>(FLAGS_env->NowMicros())) {}
+
+  // Waits for the scheduled start of the next request and returns it.
+  uint64_t WaitForNext() {
+    const uint64_t start = static_cast<uint64_t>(next_micros_);
+    double gap = interval_micros_;
+    if (arrival_ == kPoissonArrival) {
+      // exponential gaps, from a uniform double in [0, 1)
+      const double u = (rand_.Next() >> 11) * (1.0 / (uint64_t{1} << 53));
+      gap = -std::log1p(-u) * interval_micros_;
+    }
+    next_micros_ += gap;
+    const uint64_t now = FLAGS_env->NowMicros();
+    if (start > now) {
+      FLAGS_env->SleepForMicroseconds(static_cast<int>(start - now));
+    }
+    return start;
+  }
+
+ private:
+  const YCSBArrival arrival_;
+  const double interval_micros_;
+  Random64 rand_;
+  double next_micros_;
+};
+
 class Benchmark {
  private:
   std::shared_ptr<Cache> cache_;
@@ -3854,10 +3973,13 @@ class Benchmark {
 
     std::unique_ptr<ReporterAgent> reporter_agent;
     if (FLAGS_report_interval_seconds > 0) {
-      if ( FLAGS_DOTA_enabled || FLAGS_TEA_enable ||
-          FLAGS_FEA_enable || FLAGS_ARK_enable) {
+      const auto& tuning_policy = open_options_.tuning_policy;
+      if (tuning_policy != nullptr || FLAGS_DOTA_enabled ||
+          FLAGS_TEA_enable || FLAGS_FEA_enable || FLAGS_ARK_enable) {
         // need to use another Report Agent
-        bool report_total_thread_only = !FLAGS_ARK_enable;
+        bool report_total_thread_only =
+            tuning_policy != nullptr ? tuning_policy->GetId() != "ARK"
+                                     : !FLAGS_ARK_enable;
         if (FLAGS_DOTA_tuning_gap == 0) {
           reporter_agent.reset(new ReporterAgentWithTuning(
               reinterpret_cast<DBImpl*>(db_.db), FLAGS_env, FLAGS_report_file,
@@ -3871,11 +3993,16 @@ class Benchmark {
         }
         auto tuner_agent =
             reinterpret_cast<ReporterAgentWithTuning*>(reporter_agent.get());
-        tuner_agent->UseFEATTuner(FLAGS_TEA_enable, FLAGS_FEA_enable,
-                                  FLAGS_ARK_enable);
+        // a policy from the DB options is picked up by the agent itself
+        if (tuning_policy == nullptr) {
+          tuner_agent->UseFEATTuner(FLAGS_TEA_enable, FLAGS_FEA_enable,
+                                    FLAGS_ARK_enable);
+        }
         tuner_agent->GetTuner()->set_idle_ratio(FLAGS_idle_rate);
         tuner_agent->GetTuner()->set_gap_threshold(FLAGS_FEA_gap_threshold);
         tuner_agent->GetTuner()->set_slow_flush_threshold(FLAGS_TEA_slow_flush);
+        tuner_agent->GetTuner()->set_max_stall_limit_ratio(
+            FLAGS_ARK_max_stall_limit_ratio);
       } else if (FLAGS_detailed_running_stats) {
         reporter_agent.reset(new ReporterWithMoreDetails(
             reinterpret_cast<DBImpl*>(db_.db), FLAGS_env, FLAGS_report_file,
@@ -4653,6 +4780,30 @@ class Benchmark {
 
     options.core_number = FLAGS_core_num;
     options.max_memtable_size = FLAGS_max_memtable_size;
+    options.shrink_background_threads = FLAGS_shrink_background_threads;
+    if (!FLAGS_tuning_policy.empty()) {
+      ConfigOptions config_options(options);
+      Status s = TuningPolicy::CreateFromString(
+          config_options, FLAGS_tuning_policy, &options.tuning_policy);
+      if (!s.ok()) {
+        fprintf(stderr, "invalid tuning policy[%s]: %s\n",
+                FLAGS_tuning_policy.c_str(), s.ToString().c_str());
+        exit(1);
+      }
+    }
+    options.tuner_trace_file = FLAGS_tuner_trace_file;
+    options.tuner_state_file = FLAGS_tuner_state_file;
+    if (!strcasecmp(FLAGS_tuning_objective.c_str(), "latency")) {
+      options.tuning_objective = TuningObjective::kLatency;
+    } else if (!strcasecmp(FLAGS_tuning_objective.c_str(), "throughput")) {
+      options.tuning_objective = TuningObjective::kThroughput;
+    } else {
+      fprintf(stderr, "invalid tuning objective[%s]\n",
+              FLAGS_tuning_objective.c_str());
+      exit(1);
+    }
+    options.tuning_memory_budget = FLAGS_tuning_memory_budget;
+    options.tuning_trigger_interval_ms = FLAGS_tuning_trigger_interval_ms;
 
 
     if (options.statistics == nullptr) {
@@ -4956,6 +5107,40 @@ class Benchmark {
   void WriteUniqueRandom(ThreadState* thread) {
     DoWrite(thread, UNIQUE_RANDOM);
   }
+  // The schedule of this thread's requests, nullptr for the closed loop.
+  // `phase` overrides the rate of the flags. A request of `keys_per_request`
+  // keys counts as that many ops.
+  std::unique_ptr<ArrivalSchedule> NewYCSBSchedule(
+      ThreadState* thread, const ycsbc::LoadPhase* phase = nullptr,
+      int64_t keys_per_request = 1) {
+    if (phase != nullptr) {
+      if (phase->ops_per_sec <= 0) {
+        return nullptr;
+      }
+      return std::unique_ptr<ArrivalSchedule>(new ArrivalSchedule(
+          FLAGS_ycsb_arrival_e == kPoissonArrival ? kPoissonArrival
+                                                  : kConstantArrival,
+          phase->ops_per_sec / std::max(FLAGS_threads, 1),
+          thread->rand.Next()));
+    }
+    if (FLAGS_ycsb_arrival_e == kClosedLoop) {
+      return nullptr;
+    }
+    double ops_per_sec = static_cast<double>(FLAGS_ycsb_request_ops);
+    if (ops_per_sec <= 0) {
+      ops_per_sec = FLAGS_ycsb_request_speed * 1048576.0 /
+                    std::max(FLAGS_key_size + FLAGS_value_size, 1);
+    }
+    ops_per_sec /= std::max(FLAGS_threads, 1);
+    if (ops_per_sec <= 0) {
+      fprintf(stderr, "open-loop YCSB needs a request rate\n");
+      exit(1);
+    }
+    ops_per_sec /= std::max<int64_t>(keys_per_request, 1);
+    return std::unique_ptr<ArrivalSchedule>(new ArrivalSchedule(
+        FLAGS_ycsb_arrival_e, ops_per_sec, thread->rand.Next()));
+  }
+
   void YCSBWorking(ThreadState* thread, ycsbc::CoreWorkload* workload, int load,
                    int run) {
     int remain_loading = FLAGS_load_num;
@@ -4976,8 +5161,15 @@ class Benchmark {
     rocksdb::WriteOptions w_op;
 
     if (load) {
+      std::unique_ptr<ArrivalSchedule> schedule =
+          NewYCSBSchedule(thread, nullptr, entries_per_batch_);
+      // the keys of a batch, by the DB they go to
+      std::vector<std::vector<std::string>> db_keys(
+          db_.db != nullptr ? 1 : multi_dbs_.size());
+      WriteBatch batch;
       while (!duration.Done(entries_per_batch_)) {
-        DB* db = SelectDB(thread);
+        const uint64_t start =
+            schedule != nullptr ? schedule->WaitForNext() : 0;
         if (duration.GetStage() != stage) {
           stage = duration.GetStage();
           if (db_.db != nullptr) {
@@ -4988,22 +5180,59 @@ class Benchmark {
             }
           }
         }
-        std::string key = workload->BuildKeyName();
-        Slice val = gen.Generate();
-        db_.db->Put(w_op, key, val);
+        for (int64_t j = 0; j < entries_per_batch_; j++) {
+          std::string key = workload->BuildKeyName();
+          db_keys[YCSBDBIndex(key)].push_back(std::move(key));
+        }
 
         int64_t batch_bytes = 0;
-        for (int64_t j = 0; j < entries_per_batch_; j++) {
-          batch_bytes += val.size() + key.size();
-          bytes += val.size() + key.size();
+        for (size_t i = 0; i < db_keys.size(); i++) {
+          auto& keys = db_keys[i];
+          if (keys.empty()) {
+            continue;
+          }
+          if (FLAGS_ycsb_sort_batch) {
+            std::sort(keys.begin(), keys.end());
+          }
+          DB* db = SelectDBWithCfh(i)->db;
+          if (keys.size() == 1) {
+            Slice val = gen.Generate();
+            s = db->Put(w_op, keys[0], val);
+            batch_bytes += keys[0].size() + val.size();
+          } else {
+            batch.Clear();
+            for (const auto& key : keys) {
+              Slice val = gen.Generate();
+              s = batch.Put(key, val);
+              if (!s.ok()) {
+                break;
+              }
+              batch_bytes += key.size() + val.size();
+            }
+            if (s.ok()) {
+              s = db->Write(w_op, &batch);
+            }
+          }
+          if (!s.ok()) {
+            fprintf(stderr, "ycsb load error: %s\n", s.ToString().c_str());
+            exit(1);
+          }
+          if (schedule != nullptr) {
+            // every DB's write of the batch counts from the batch's start
+            thread->stats.SetLastOpTime(start);
+          }
+          thread->stats.FinishedOps(nullptr, db, keys.size(), kWrite);
+          keys.clear();
         }
+        bytes += batch_bytes;
         if (thread->shared->write_rate_limiter.get() != nullptr) {
           thread->shared->write_rate_limiter->Request(
               batch_bytes, Env::IO_HIGH, nullptr /* stats */,
               RateLimiter::OpType::kWrite);
-          thread->stats.ResetLastOpTime();
+          if (schedule == nullptr) {
+            thread->stats.ResetLastOpTime();
+          }
         }
-        thread->stats.FinishedOps(nullptr, db, entries_per_batch_, kWrite);
       }
       thread->stats.AddBytes(bytes);
     }
@@ -5015,7 +5244,37 @@ class Benchmark {
       int read_count = 0;
       int found_count = 0;
       int blind_updates = 0;
+      std::unique_ptr<ArrivalSchedule> schedule = NewYCSBSchedule(thread);
+      // with ycsb_native_scan, the iterators of the thread by DB, all bound
+      // by scan_upper_bound
+      std::vector<std::unique_ptr<Iterator>> scan_iters(
+          db_.db != nullptr ? 1 : multi_dbs_.size());
+      std::string scan_bound;
+      Slice scan_upper_bound;
+      ReadOptions scan_options = read_options_;
+      scan_options.iterate_upper_bound = &scan_upper_bound;
+      PinnableSlice pinned;
+      const ycsbc::LoadProfile& profile = FLAGS_ycsb_load_profile_v;
+      // the phase is looked up every kPhaseCheckMicros
+      const uint64_t kPhaseCheckMicros = 100000;
+      const uint64_t run_start = FLAGS_env->NowMicros();
+      uint64_t next_phase_check = run_start;
+      size_t phase = profile.phases().size();
       while (!duration.Done(1)) {
+        const uint64_t now = profile.empty() ? 0 : FLAGS_env->NowMicros();
+        if (!profile.empty() && now >= next_phase_check) {
+          next_phase_check = now + kPhaseCheckMicros;
+          const size_t current = profile.PhaseAt(
+              static_cast<double>(now - run_start) / kMicrosInSecond);
+          if (current != phase) {
+            phase = current;
+            workload->SetPhase(profile.phases()[phase]);
+            schedule = NewYCSBSchedule(thread, &profile.phases()[phase]);
+          }
+        }
+        if (schedule != nullptr) {
+          thread->stats.SetLastOpTime(schedule->WaitForNext());
+        }
         if (duration.GetStage() != stage) {
           stage = duration.GetStage();
           if (db_.db != nullptr) {
@@ -5029,13 +5288,22 @@ class Benchmark {
         std::string data;
         uint64_t key_num = workload->NextTransactionKeyNum();
         const std::string key = workload->BuildKeyName(key_num);
-        DB* db = SelectDB(thread);
+        DB* db = SelectYCSBDB(key);
         switch (workload->NextOp()) {
           case ycsbc::READ: {
-            op_status = db_.db->Get(r_op, key, &data);
+            size_t value_size = 0;
+            if (FLAGS_ycsb_native_scan) {
+              pinned.Reset();
+              op_status =
+                  db->Get(r_op, db->DefaultColumnFamily(), key, &pinned);
+              value_size = pinned.size();
+            } else {
+              op_status = db->Get(r_op, key, &data);
+              value_size = data.size();
+            }
             if (op_status.ok()) {
               found_count++;
-              bytes += key.size() + data.size();
+              bytes += key.size() + value_size;
             }
             read_count++;
             thread->stats.FinishedOps(nullptr, db, entries_per_batch_, kRead);
@@ -5043,38 +5311,60 @@ class Benchmark {
           case ycsbc::UPDATE: {
             Slice val = gen.Generate();
             // In rocksdb, update is just another put operation.
-            op_status = db_.db->Put(w_op, key, val);
+            op_status = db->Put(w_op, key, val);
             thread->stats.FinishedOps(nullptr, db, entries_per_batch_, kUpdate);
           } break;
           case ycsbc::INSERT: {
             Slice val = gen.Generate();
             // In rocksdb, update is just another put operation.
-            op_status = db_.db->Put(w_op, key, val);
+            op_status = db->Put(w_op, key, val);
             thread->stats.FinishedOps(nullptr, db, entries_per_batch_, kWrite);
           } break;
           case ycsbc::SCAN: {
-            Iterator* db_iter = db_.db->NewIterator(rocksdb::ReadOptions());
-            db_iter->Seek(key);
             int len = workload->scan_len_chooser_->Next();
-            for (int i = 0; db_iter->Valid() && i < len; i++) {
-              data = db_iter->value().ToString();
-              db_iter->Next();
+            if (FLAGS_ycsb_native_scan) {
+              scan_bound = workload->ScanUpperBound(key_num, len);
+              scan_upper_bound = scan_bound;
+              auto& db_iter = scan_iters[YCSBDBIndex(key)];
+              // a tailing iterator sees new writes by itself
+              if (db_iter == nullptr ||
+                  (!scan_options.tailing && !db_iter->Refresh().ok())) {
+                db_iter.reset(db->NewIterator(scan_options));
+              }
+              db_iter->Seek(key);
+              for (int i = 0; db_iter->Valid() && i < len; i++) {
+                bytes += db_iter->key().size() + db_iter->value().size();
+                db_iter->Next();
+              }
+            } else {
+              Iterator* db_iter = db->NewIterator(rocksdb::ReadOptions());
+              db_iter->Seek(key);
+              for (int i = 0; db_iter->Valid() && i < len; i++) {
+                data = db_iter->value().ToString();
+                db_iter->Next();
+              }
+              delete db_iter;
             }
             thread->stats.FinishedOps(nullptr, db, entries_per_batch_, kSeek);
-            delete db_iter;
           } break;
           case ycsbc::READMODIFYWRITE: {
-            op_status = db_.db->Get(r_op, key, &data);
+            if (FLAGS_ycsb_native_scan) {
+              pinned.Reset();
+              op_status =
+                  db->Get(r_op, db->DefaultColumnFamily(), key, &pinned);
+            } else {
+              op_status = db->Get(r_op, key, &data);
+            }
             read_count++;
             if (op_status.IsNotFound()) {
               blind_updates++;
             }
             Slice val = gen.Generate();
-            op_status = db_.db->Put(w_op, key, val);
+            op_status = db->Put(w_op, key, val);
             thread->stats.FinishedOps(nullptr, db, entries_per_batch_, kUpdate);
           } break;
           case ycsbc::DELETE: {
-            op_status = db_.db->Delete(w_op, key);
+            op_status = db->Delete(w_op, key);
             thread->stats.FinishedOps(nullptr, db, entries_per_batch_, kDelete);
           } break;
           case ycsbc::MAXOPTYPE:
@@ -5599,6 +5889,16 @@ const double bandwidth_in_one_hour[3600] = {
     }
   }
 
+  // The DB of a YCSB key. With num_multi_db the keys are spread over the DBs
+  // by their hash, so the run phase finds the keys of the load phase.
+  size_t YCSBDBIndex(const Slice& key) {
+    return db_.db != nullptr ? 0 : GetSliceNPHash64(key) % multi_dbs_.size();
+  }
+
+  DB* SelectYCSBDB(const Slice& key) {
+    return SelectDBWithCfh(YCSBDBIndex(key))->db;
+  }
+
   double SineRate(double x) {
     return FLAGS_sine_a*sin((FLAGS_sine_b*x) + FLAGS_sine_c) + FLAGS_sine_d;
   }
@@ -9214,6 +9514,26 @@ int db_bench_tool(int argc, char** argv) {
 
   FLAGS_value_size_distribution_type_e =
     StringToDistributionType(FLAGS_value_size_distribution_type.c_str());
+  FLAGS_ycsb_arrival_e = StringToYCSBArrival(FLAGS_ycsb_arrival.c_str());
+  if (FLAGS_ycsb_arrival_e != kClosedLoop) {
+    // open-loop latencies count from the scheduled start, which only the
+    // histograms record
+    FLAGS_histogram = true;
+  }
+  if (!FLAGS_ycsb_load_profile.empty()) {
+    try {
+      FLAGS_ycsb_load_profile_v =
+          ycsbc::LoadProfile::FromFile(FLAGS_ycsb_load_profile);
+    } catch (const ycsbc::utils::Exception& e) {
+      fprintf(stderr, "%s\n", e.what());
+      exit(1);
+    }
+    for (const auto& phase : FLAGS_ycsb_load_profile_v.phases()) {
+      if (phase.ops_per_sec > 0) {
+        FLAGS_histogram = true;
+      }
+    }
+  }
 
   // Note options sanitization may increase thread pool sizes according to
   // max_background_flushes/max_background_compactions/max_background_jobs
@@ -0,0 +1,157 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//    This source code is licensed under both the GPLv2 (found in the
+//    COPYING file in the root directory) and Apache 2.0 License
+//    (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+#ifdef GFLAGS
+#include "tools/tuner_replay_tool.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+
+#include "rocksdb/convenience.h"
+#include "rocksdb/utilities/tuning_policy.h"
+#include "util/gflags_compat.h"
+#include "utilities/DOTA/tuner_trace.h"
+
+using GFLAGS_NAMESPACE::ParseCommandLineFlags;
+
+DEFINE_string(tuner_trace_file, "", "The tuner trace file path.");
+DEFINE_string(tuning_policy, "",
+              "Policy to replay the trace through, as an options string. "
+              "Defaults to the traced policy.");
+DEFINE_bool(print_all_rounds, false,
+            "Print every round, not only the ones that decided differently.");
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+bool SameOp(const TuningOP& a, const TuningOP& b) {
+  return a.BatchOp == b.BatchOp && a.ThreadOp == b.ThreadOp &&
+         a.FlushThreadOp == b.FlushThreadOp &&
+         a.CompactionThreadOp == b.CompactionThreadOp &&
+         a.SSTableOp == b.SSTableOp && a.RateLimitOp == b.RateLimitOp &&
+         a.WriteBufferNumberOp == b.WriteBufferNumberOp &&
+         a.MergeWidthOp == b.MergeWidthOp &&
+         a.StallLimitOp == b.StallLimitOp &&
+         a.DeepCompactionOp == b.DeepCompactionOp;
+}
+
+bool SameChanges(const std::vector<ChangePoint>& a,
+                 const std::vector<ChangePoint>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].opt != b[i].opt || a[i].value != b[i].value ||
+        a[i].db_width != b[i].db_width ||
+        (!a[i].db_width && a[i].cf_id != b[i].cf_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+TunerReplayer::TunerReplayer(Env* env, const std::string& trace_file,
+                             const std::string& policy, bool print_all_rounds)
+    : env_(env),
+      trace_file_(trace_file),
+      policy_(policy),
+      print_all_rounds_(print_all_rounds) {}
+
+void TunerReplayer::PrintRound(const TunerTraceRecord& traced,
+                               const TunerTraceRecord& replayed,
+                               bool diverged) {
+  fprintf(stdout, "%s secs_elapsed=%d\n  traced:   %s\n  replayed: %s\n",
+          diverged ? "DIFF" : "SAME", traced.secs_elapsed,
+          traced.DecisionString().c_str(), replayed.DecisionString().c_str());
+}
+
+int TunerReplayer::Replay() {
+  std::unique_ptr<TunerTraceReader> reader;
+  Status s = TunerTraceReader::Open(env_, trace_file_, &reader);
+  if (!s.ok()) {
+    fprintf(stderr, "%s: %s\n", trace_file_.c_str(), s.ToString().c_str());
+    return 1;
+  }
+  const std::string& policy_id =
+      policy_.empty() ? reader->header().policy : policy_;
+  std::shared_ptr<TuningPolicy> policy;
+  ConfigOptions config_options;
+  s = TuningPolicy::CreateFromString(config_options, policy_id, &policy);
+  if (s.ok() && policy == nullptr) {
+    s = Status::InvalidArgument("no tuning policy");
+  }
+  if (!s.ok()) {
+    fprintf(stderr, "policy[%s]: %s\n", policy_id.c_str(),
+            s.ToString().c_str());
+    return 1;
+  }
+  fprintf(stdout, "Replaying a %s trace through %s\n",
+          reader->header().policy.c_str(), policy->GetId().c_str());
+
+  FEAT_Tuner tuner(reader->header(), env_, policy);
+  uint64_t rounds = 0;
+  uint64_t traced_decisions = 0;
+  uint64_t replayed_decisions = 0;
+  uint64_t diff_ops = 0;
+  uint64_t diff_changes = 0;
+  uint64_t diff_counters = 0;
+  while (true) {
+    TunerTraceRecord traced;
+    s = reader->Read(&traced);
+    if (!s.ok()) {
+      break;
+    }
+    TunerTraceRecord replayed;
+    tuner.ReplayRound(traced, &replayed);
+    rounds++;
+    traced_decisions += traced.decided ? 1 : 0;
+    replayed_decisions += replayed.decided ? 1 : 0;
+
+    const bool same_op =
+        traced.decided == replayed.decided &&
+        (!traced.decided || SameOp(traced.op, replayed.op));
+    const bool same_changes =
+        SameChanges(traced.change_points, replayed.change_points);
+    const bool same_counters = traced.after == replayed.after;
+    diff_ops += same_op ? 0 : 1;
+    diff_changes += same_changes ? 0 : 1;
+    diff_counters += same_counters ? 0 : 1;
+    const bool diverged = !same_op || !same_changes;
+    if (diverged || print_all_rounds_) {
+      PrintRound(traced, replayed, diverged);
+    }
+  }
+  if (!s.IsIncomplete()) {
+    fprintf(stderr, "%s: %s\n", trace_file_.c_str(), s.ToString().c_str());
+    return 1;
+  }
+  fprintf(stdout,
+          "rounds: %" PRIu64 ", decisions traced: %" PRIu64
+          ", replayed: %" PRIu64 "\n"
+          "rounds with other ops: %" PRIu64 ", other changes: %" PRIu64
+          ", other ARK counters: %" PRIu64 "\n",
+          rounds, traced_decisions, replayed_decisions, diff_ops, diff_changes,
+          diff_counters);
+  return 0;
+}
+
+int tuner_replay(int argc, char** argv) {
+  ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_tuner_trace_file.empty()) {
+    fprintf(stderr, "Tuner trace file path is empty\n");
+    return 1;
+  }
+
+  TunerReplayer replayer(Env::Default(), FLAGS_tuner_trace_file,
+                         FLAGS_tuning_policy, FLAGS_print_all_rounds);
+  return replayer.Replay();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // GFLAGS
+#endif  // ROCKSDB_LITE
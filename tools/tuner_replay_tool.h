@@ -0,0 +1,42 @@
+// Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+// This source code is licensed under both the GPLv2 (found in the
+// COPYING file in the root directory) and Apache 2.0 License
+// (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+#pragma once
+
+#include <string>
+
+#include "rocksdb/env.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct TunerTraceRecord;
+
+// TunerReplayer feeds a tuner trace (see utilities/DOTA/tuner_trace.h) through
+// a tuning policy and prints the rounds where the policy decides differently
+// from the traced tuner.
+class TunerReplayer {
+ public:
+  // An empty `policy` replays the trace through the traced policy.
+  TunerReplayer(Env* env, const std::string& trace_file,
+                const std::string& policy, bool print_all_rounds);
+
+  int Replay();
+
+ private:
+  void PrintRound(const TunerTraceRecord& traced,
+                  const TunerTraceRecord& replayed, bool diverged);
+
+  Env* env_;
+  std::string trace_file_;
+  std::string policy_;
+  bool print_all_rounds_;
+};
+
+int tuner_replay(int argc, char** argv);
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -7,6 +7,23 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+void QuicksandMetrics::Reset() {
+  input_level = 0;
+  output_level = 1;
+  drop_ratio = 0.0;
+  write_out_bandwidth = 0.0;
+  read_in_bandwidth = 0.0;
+  max_bg_compaction = 0;
+  max_bg_flush = 0;
+  cpu_time_ratio = 0.0;
+  total_micros = 0.0;
+  write_amplification = 0.0;
+  total_bytes = 0;
+  current_pending_bytes = 0;
+  immu_num = 0;
+  io_stat.Reset();
+}
+
 #ifndef ROCKSDB_LITE
 
 void CompactionJobStats::Reset() {
@@ -0,0 +1,158 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A fixed-capacity, lock-free ring of metric records. Any number of threads
+// may Push() concurrently (flush jobs, compaction jobs, pool threads) while
+// any number of readers consume the records with their own cursor.
+//
+// Memory stays constant: once the ring is full the oldest records are
+// overwritten. A reader that falls more than Capacity() records behind skips
+// the overwritten ones and is told how many it lost.
+//
+// Every slot is guarded by a sequence number (seqlock style): it is odd while
+// a producer writes the slot and becomes 2 * (ticket + 1) once the record of
+// `ticket` is published. Readers copy the payload and re-check the sequence,
+// so T must be trivially copyable.
+template <typename T>
+class MetricsRingBuffer {
+ public:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "MetricsRingBuffer only stores trivially copyable records");
+
+  static constexpr size_t kDefaultCapacity = 4096;
+
+  // capacity is rounded up to a power of two
+  explicit MetricsRingBuffer(size_t capacity = kDefaultCapacity)
+      : capacity_(RoundUpToPowerOfTwo(capacity)),
+        mask_(capacity_ - 1),
+        slots_(new Slot[capacity_]),
+        next_ticket_(0) {}
+
+  MetricsRingBuffer(const MetricsRingBuffer&) = delete;
+  MetricsRingBuffer& operator=(const MetricsRingBuffer&) = delete;
+
+  size_t Capacity() const { return capacity_; }
+
+  // Number of records ever pushed. This is also the cursor value a reader
+  // should start from to see only records pushed from now on.
+  uint64_t Head() const {
+    return next_ticket_.load(std::memory_order_acquire);
+  }
+
+  // Thread safe, never blocks on readers.
+  void Push(const T& record) {
+    const uint64_t ticket =
+        next_ticket_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[ticket & mask_];
+    const uint64_t writing = 2 * ticket + 1;
+    uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    while (true) {
+      if (seq > writing) {
+        // A producer one lap ahead already owns this slot, our record is
+        // older than anything a reader could still want.
+        return;
+      }
+      if ((seq & 1) != 0) {
+        // The previous lap is still being written, wait for it.
+        std::this_thread::yield();
+        seq = slot.seq.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (slot.seq.compare_exchange_weak(seq, writing,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(static_cast<void*>(&slot.record), &record, sizeof(T));
+    slot.seq.store(writing + 1, std::memory_order_release);
+  }
+
+  // Visit every record published since *cursor in push order, then advance
+  // *cursor past them. Stops early at a record that is still being written so
+  // that it is delivered by the next call. Returns the number of records that
+  // were overwritten before this reader got to them.
+  template <typename Visitor>
+  uint64_t ConsumeSince(uint64_t* cursor, Visitor&& visit) const {
+    assert(cursor != nullptr);
+    const uint64_t head = Head();
+    uint64_t lost = 0;
+    uint64_t ticket = *cursor;
+    if (ticket > head) {
+      ticket = head;
+    }
+    if (head - ticket > capacity_) {
+      lost += head - ticket - capacity_;
+      ticket = head - capacity_;
+    }
+    T record;
+    for (; ticket < head; ticket++) {
+      const Slot& slot = slots_[ticket & mask_];
+      const uint64_t published = 2 * ticket + 2;
+      const uint64_t before = slot.seq.load(std::memory_order_acquire);
+      if (before < published) {
+        // not published yet
+        break;
+      }
+      if (before == published) {
+        std::memcpy(static_cast<void*>(&record), &slot.record, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before) {
+          visit(record);
+          continue;
+        }
+      }
+      // overwritten by a later lap
+      lost++;
+    }
+    *cursor = ticket;
+    return lost;
+  }
+
+  // Same as above, appending the records to *records.
+  uint64_t ReadSince(uint64_t* cursor, std::vector<T>* records) const {
+    assert(records != nullptr);
+    return ConsumeSince(cursor,
+                        [records](const T& r) { records->push_back(r); });
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    T record{};
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t n) {
+    size_t result = 1;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const size_t capacity_;
+  const uint64_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> next_ticket_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
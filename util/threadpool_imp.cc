@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
@@ -32,6 +33,7 @@
 #include "monitoring/thread_status_util.h"
 #include "port/port.h"
 #include "test_util/sync_point.h"
+#include "util/metrics_ring_buffer.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -53,9 +55,14 @@ struct ThreadPoolImpl::Impl {
   void SetBackgroundThreadsInternal(int num, bool allow_reduce);
   int GetBackgroundThreads();
   //for fEAT
-  std::vector<std::pair<size_t, uint64_t>>* GetThreadPoolWaiting() {
-    return &this->thread_waiting_time;
-  };
+  uint64_t GetThreadPoolWaiting(uint64_t* cursor) const {
+    uint64_t waiting_micros = 0;
+    thread_waiting_time.ConsumeSince(
+        cursor, [&waiting_micros](const ThreadWaitingRecord& record) {
+          waiting_micros += record.waiting_micros;
+        });
+    return waiting_micros;
+  }
   std::string GetThreadPoolTiming() {
     std::stringstream ss;
     ss << "timestamp (micros) of each thread creating\n";
@@ -66,9 +73,11 @@ struct ThreadPoolImpl::Impl {
     ss << "micro seconds waiting for next mission"
        << "\n";
 
-    for (auto pair : thread_waiting_time) {
-      ss << pair.first << " : " << pair.second << "\n";
-    }
+    uint64_t cursor = 0;
+    thread_waiting_time.ConsumeSince(
+        &cursor, [&ss](const ThreadWaitingRecord& record) {
+          ss << record.thread_id << " : " << record.waiting_micros << "\n";
+        });
     ss << "\n";
     return ss.str();
   }
@@ -144,7 +153,14 @@ struct ThreadPoolImpl::Impl {
   }
 // for FEAT
 
-  std::vector<std::pair<size_t, uint64_t>> thread_waiting_time;
+  // One idle period of a pool thread, recorded each time it picks up a job.
+  struct ThreadWaitingRecord {
+    size_t thread_id;
+    uint64_t waiting_micros;
+  };
+  // Fixed-size so that long runs do not grow memory, and lock free so the
+  // tuner can read it while pool threads keep recording.
+  MetricsRingBuffer<ThreadWaitingRecord> thread_waiting_time;
   std::vector<std::pair<std::string, uint64_t>> thread_creating_time;
 private:
  static void BGThreadWrapper(void* arg);
@@ -184,9 +200,8 @@ private:
   std::vector<port::Thread> bgthreads_;
 };
 
-std::vector<std::pair<size_t, uint64_t>>*
-ThreadPoolImpl::GetThreadWaitingTime() {
-  return &impl_->thread_waiting_time;
+uint64_t ThreadPoolImpl::GetThreadWaitingTime(uint64_t* cursor) {
+  return impl_->GetThreadPoolWaiting(cursor);
 }
 std::vector<std::pair<std::string, uint64_t>>*
 ThreadPoolImpl::GetThreadCreatingTime() {
@@ -270,11 +285,16 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
     // 2) it is the excessive thread (not the last one)
     // 3) the number of waiting threads is not greater than reserved threads
     // (i.e, no available threads due to full reservation")
+    const auto wait_start = std::chrono::steady_clock::now();
     while (!exit_all_threads_ && !IsLastExcessiveThread(thread_id) &&
            (queue_.empty() || IsExcessiveThread(thread_id) ||
             num_waiting_threads_ <= reserved_threads_)) {
       bgsignal_.wait(lock);
     }
+    const uint64_t waiting_micros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - wait_start)
+            .count());
     // Decrease num_waiting_threads_ once the thread is not waiting
     num_waiting_threads_--;
 
@@ -313,6 +333,8 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
     CpuPriority cpu_priority = cpu_priority_;
     lock.unlock();
 
+    thread_waiting_time.Push({thread_id, waiting_micros});
+
     if (cpu_priority < current_cpu_priority) {
       TEST_SYNC_POINT_CALLBACK("ThreadPoolImpl::BGThread::BeforeSetCpuPriority",
                                &current_cpu_priority);
@@ -100,7 +100,9 @@ class ThreadPoolImpl : public ThreadPool {
 
   struct Impl;
 //for FEAT
-  std::vector<std::pair<size_t, uint64_t>>* GetThreadWaitingTime();
+  // Sum of the micros the pool threads idled waiting for a job since *cursor,
+  // advancing *cursor past the consumed samples. Lock free.
+  uint64_t GetThreadWaitingTime(uint64_t* cursor);
   std::vector<std::pair<std::string,uint64_t>>* GetThreadCreatingTime();
   std::string GetThreadTimingString();
  private:
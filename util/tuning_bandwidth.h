@@ -0,0 +1,105 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Learns the bandwidth the device under a DB sustains, from the bytes its
+// FileSystem wrote and read. A round only shows what the device can deliver
+// when work was waiting for it, otherwise it shows the demand. So the
+// estimate is only taken from the busy rounds: an idle round that moved more
+// than the estimate was absorbed by the page cache. Until kMinSamples busy
+// rounds were seen the bandwidth is unknown and the utilization is 0.
+// Not thread-safe, the tuner updates it once per round.
+class TuningBandwidth {
+ public:
+  static constexpr size_t kMinSamples = 4;
+  static constexpr size_t kDefaultWindow = 32;
+
+  struct Round {
+    double write_mbps = 0.0;
+    double read_mbps = 0.0;
+    // share of the sustainable bandwidth the round used, 0 if unknown
+    double utilization = 0.0;
+  };
+
+  explicit TuningBandwidth(size_t window = kDefaultWindow)
+      : window_(std::max(window, kMinSamples)) {}
+
+  // `bytes_written` and `bytes_read` are running totals, `busy` tells whether
+  // background work was waiting during the `secs` since the last update.
+  Round Update(uint64_t bytes_written, uint64_t bytes_read, double secs,
+               bool busy) {
+    Round round;
+    const bool first = !started_;
+    const uint64_t written =
+        bytes_written > last_written_ ? bytes_written - last_written_ : 0;
+    const uint64_t read = bytes_read > last_read_ ? bytes_read - last_read_ : 0;
+    started_ = true;
+    last_written_ = bytes_written;
+    last_read_ = bytes_read;
+    if (first || secs <= 0) {
+      return round;
+    }
+    round.write_mbps = written / secs / kMB;
+    round.read_mbps = read / secs / kMB;
+    const double total = round.write_mbps + round.read_mbps;
+    if (busy) {
+      AddSample(round);
+    }
+    const double learned = SustainableMBps();
+    if (learned > 0) {
+      round.utilization = total / learned;
+    }
+    return round;
+  }
+
+  // MB/s of reads and writes together the device sustains, 0 if unknown.
+  double SustainableMBps() const { return Percentile(totals_); }
+  double SustainableWriteMBps() const { return Percentile(writes_); }
+  double SustainableReadMBps() const { return Percentile(reads_); }
+
+ private:
+  static constexpr double kMB = 1024.0 * 1024.0;
+  // A single burst absorbed by the page cache must not become the estimate.
+  static constexpr double kPercentile = 0.9;
+
+  void AddSample(const Round& round) {
+    if (totals_.size() == window_) {
+      totals_.erase(totals_.begin());
+      writes_.erase(writes_.begin());
+      reads_.erase(reads_.begin());
+    }
+    totals_.push_back(round.write_mbps + round.read_mbps);
+    writes_.push_back(round.write_mbps);
+    reads_.push_back(round.read_mbps);
+  }
+
+  static double Percentile(const std::vector<double>& samples) {
+    if (samples.size() < kMinSamples) {
+      return 0.0;
+    }
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[static_cast<size_t>(kPercentile * (sorted.size() - 1))];
+  }
+
+  const size_t window_;
+  bool started_ = false;
+  uint64_t last_written_ = 0;
+  uint64_t last_read_ = 0;
+  std::vector<double> totals_;
+  std::vector<double> writes_;
+  std::vector<double> reads_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
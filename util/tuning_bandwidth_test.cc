@@ -0,0 +1,96 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/tuning_bandwidth.h"
+
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class TuningBandwidthTest : public testing::Test {
+ public:
+  static constexpr uint64_t kMB = 1 << 20;
+
+  // One round of `secs` moving the given MB/s.
+  TuningBandwidth::Round Advance(TuningBandwidth* bandwidth, uint64_t write_mb,
+                                 uint64_t read_mb, bool busy, double secs = 1) {
+    written_ += static_cast<uint64_t>(write_mb * kMB * secs);
+    read_ += static_cast<uint64_t>(read_mb * kMB * secs);
+    return bandwidth->Update(written_, read_, secs, busy);
+  }
+
+  uint64_t written_ = 0;
+  uint64_t read_ = 0;
+};
+
+TEST_F(TuningBandwidthTest, UnknownUntilBusy) {
+  TuningBandwidth bandwidth;
+  // the first update only sets the base
+  ASSERT_EQ(0.0, Advance(&bandwidth, 100, 0, true).write_mbps);
+  // idle rounds only show the demand
+  for (int i = 0; i < 10; i++) {
+    auto round = Advance(&bandwidth, 20, 10, false);
+    ASSERT_DOUBLE_EQ(20.0, round.write_mbps);
+    ASSERT_DOUBLE_EQ(10.0, round.read_mbps);
+    ASSERT_EQ(0.0, round.utilization);
+  }
+  ASSERT_EQ(0.0, bandwidth.SustainableMBps());
+
+  for (size_t i = 0; i < TuningBandwidth::kMinSamples; i++) {
+    Advance(&bandwidth, 150, 50, true);
+  }
+  ASSERT_DOUBLE_EQ(200.0, bandwidth.SustainableMBps());
+  ASSERT_DOUBLE_EQ(150.0, bandwidth.SustainableWriteMBps());
+  ASSERT_DOUBLE_EQ(50.0, bandwidth.SustainableReadMBps());
+  ASSERT_DOUBLE_EQ(0.5, Advance(&bandwidth, 80, 20, false).utilization);
+  ASSERT_DOUBLE_EQ(1.0, Advance(&bandwidth, 180, 20, true).utilization);
+}
+
+TEST_F(TuningBandwidthTest, RatesUseTheRoundLength) {
+  TuningBandwidth bandwidth;
+  Advance(&bandwidth, 0, 0, false);
+  auto round = Advance(&bandwidth, 100, 40, false, 0.5);
+  ASSERT_DOUBLE_EQ(100.0, round.write_mbps);
+  ASSERT_DOUBLE_EQ(40.0, round.read_mbps);
+}
+
+TEST_F(TuningBandwidthTest, BurstsDoNotSetTheEstimate) {
+  TuningBandwidth bandwidth;
+  Advance(&bandwidth, 0, 0, false);
+  for (int i = 0; i < 20; i++) {
+    Advance(&bandwidth, 100, 0, true);
+  }
+  // a burst absorbed by the page cache
+  Advance(&bandwidth, 1000, 0, true);
+  ASSERT_DOUBLE_EQ(100.0, bandwidth.SustainableMBps());
+
+  // a faster device shows in every busy round and replaces the old estimate
+  for (size_t i = 0; i < TuningBandwidth::kDefaultWindow; i++) {
+    Advance(&bandwidth, 300, 0, true);
+  }
+  ASSERT_DOUBLE_EQ(300.0, bandwidth.SustainableMBps());
+}
+
+TEST_F(TuningBandwidthTest, IdleBurstsDoNotRaiseTheEstimate) {
+  TuningBandwidth bandwidth;
+  Advance(&bandwidth, 0, 0, false);
+  for (size_t i = 0; i < TuningBandwidth::kMinSamples; i++) {
+    Advance(&bandwidth, 100, 0, true);
+  }
+  ASSERT_DOUBLE_EQ(100.0, bandwidth.SustainableMBps());
+
+  // writes the page cache absorbed, nothing waited for the device
+  for (size_t i = 0; i < 2 * TuningBandwidth::kDefaultWindow; i++) {
+    ASSERT_DOUBLE_EQ(5.0, Advance(&bandwidth, 500, 0, false).utilization);
+  }
+  ASSERT_DOUBLE_EQ(100.0, bandwidth.SustainableMBps());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+
+#include "monitoring/histogram.h"
+#include "port/port.h"
+#include "rocksdb/system_clock.h"
+#include "util/core_local.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Foreground latency of a DB, as seen by the tuner. The write and read paths
+// add their latency with Record(), which is lock-free and goes to the
+// histograms of the current core, like StatisticsImpl. Once per round the
+// tuner takes the percentiles of what was recorded since its previous round
+// with TakeWindow(), so the tail of the last round is not diluted by the whole
+// history as in the cumulative Statistics histograms.
+class TuningLatency {
+ public:
+  enum Kind : int { kWrite = 0, kRead, kNumKinds };
+
+  struct Window {
+    uint64_t count = 0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+  };
+
+  TuningLatency() {
+    for (int k = 0; k < kNumKinds; k++) {
+      for (auto& count : taken_[k]) {
+        count = 0;
+      }
+    }
+  }
+
+  TuningLatency(const TuningLatency&) = delete;
+  TuningLatency& operator=(const TuningLatency&) = delete;
+
+  void Record(Kind kind, uint64_t micros) {
+    per_core_.Access()->histograms_[kind].Add(micros);
+  }
+
+  // Percentiles of the latency recorded since the previous call for `kind`.
+  // Only one thread may take windows.
+  Window TakeWindow(Kind kind) {
+    HistogramStat window;
+    uint64_t count = 0;
+    uint64_t max_value = 0;
+    for (size_t b = 0; b < kNumBuckets; b++) {
+      uint64_t total = 0;
+      for (size_t core = 0; core < per_core_.Size(); core++) {
+        total += per_core_.AccessAtCore(core)->histograms_[kind].bucket_at(b);
+      }
+      // HistogramStat::Add() may still lose an update of two threads on one
+      // core, a count can go back a little
+      if (total > taken_[kind][b]) {
+        const uint64_t added = total - taken_[kind][b];
+        taken_[kind][b] = total;
+        window.buckets_[b].store(added, std::memory_order_relaxed);
+        count += added;
+        max_value = BucketMapper().BucketLimit(b);
+      }
+    }
+    Window result;
+    if (count == 0) {
+      return result;
+    }
+    window.num_.store(count, std::memory_order_relaxed);
+    window.min_.store(0, std::memory_order_relaxed);
+    window.max_.store(max_value, std::memory_order_relaxed);
+    result.count = count;
+    result.p50 = window.Median();
+    result.p99 = window.Percentile(99);
+    return result;
+  }
+
+ private:
+  static constexpr size_t kNumBuckets =
+      sizeof(HistogramStat::buckets_) / sizeof(HistogramStat::buckets_[0]);
+
+  static const HistogramBucketMapper& BucketMapper() {
+    static const HistogramBucketMapper mapper;
+    return mapper;
+  }
+
+  // a cache line of its own for every core
+  struct ALIGN_AS(CACHE_LINE_SIZE) CoreHistograms {
+    HistogramStat histograms_[kNumKinds];
+    void* operator new(size_t s) { return port::cacheline_aligned_alloc(s); }
+    void* operator new[](size_t s) { return port::cacheline_aligned_alloc(s); }
+    void operator delete(void* p) { port::cacheline_aligned_free(p); }
+    void operator delete[](void* p) { port::cacheline_aligned_free(p); }
+  };
+
+  CoreLocalArray<CoreHistograms> per_core_;
+  // the bucket counts already handed out by TakeWindow()
+  uint64_t taken_[kNumKinds][kNumBuckets];
+};
+
+// Records the time until it goes out of scope, like StopWatch. A no-op when
+// `latency` is nullptr, so the DB paths only read the clock when the tuner
+// asked for latencies.
+class TuningLatencyTimer {
+ public:
+  TuningLatencyTimer(SystemClock* clock, TuningLatency* latency,
+                     TuningLatency::Kind kind)
+      : clock_(clock),
+        latency_(latency),
+        kind_(kind),
+        start_micros_(latency != nullptr ? clock->NowMicros() : 0) {}
+
+  ~TuningLatencyTimer() {
+    if (latency_ != nullptr) {
+      latency_->Record(kind_, clock_->NowMicros() - start_micros_);
+    }
+  }
+
+  TuningLatencyTimer(const TuningLatencyTimer&) = delete;
+  TuningLatencyTimer& operator=(const TuningLatencyTimer&) = delete;
+
+ private:
+  SystemClock* clock_;
+  TuningLatency* latency_;
+  const TuningLatency::Kind kind_;
+  const uint64_t start_micros_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
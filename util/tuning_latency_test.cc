@@ -0,0 +1,112 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/tuning_latency.h"
+
+#include <thread>
+#include <vector>
+
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class TuningLatencyTest : public testing::Test {};
+
+TEST_F(TuningLatencyTest, EmptyWindow) {
+  TuningLatency latency;
+  auto window = latency.TakeWindow(TuningLatency::kWrite);
+  ASSERT_EQ(0U, window.count);
+  ASSERT_EQ(0.0, window.p99);
+}
+
+TEST_F(TuningLatencyTest, WindowsDoNotOverlap) {
+  TuningLatency latency;
+  for (int i = 0; i < 1000; i++) {
+    latency.Record(TuningLatency::kWrite, 10);
+  }
+  auto first = latency.TakeWindow(TuningLatency::kWrite);
+  ASSERT_EQ(1000U, first.count);
+  ASSERT_LE(first.p99, 10.0);
+
+  // a slow round after a fast one only shows the slow latencies
+  for (int i = 0; i < 100; i++) {
+    latency.Record(TuningLatency::kWrite, 5000);
+  }
+  auto second = latency.TakeWindow(TuningLatency::kWrite);
+  ASSERT_EQ(100U, second.count);
+  ASSERT_GT(second.p50, 1000.0);
+  ASSERT_GT(second.p99, 1000.0);
+
+  ASSERT_EQ(0U, latency.TakeWindow(TuningLatency::kWrite).count);
+  // the kinds are kept apart
+  ASSERT_EQ(0U, latency.TakeWindow(TuningLatency::kRead).count);
+}
+
+TEST_F(TuningLatencyTest, TailOfTheWindow) {
+  TuningLatency latency;
+  for (int i = 0; i < 990; i++) {
+    latency.Record(TuningLatency::kRead, 10);
+  }
+  for (int i = 0; i < 10; i++) {
+    latency.Record(TuningLatency::kRead, 10000);
+  }
+  auto window = latency.TakeWindow(TuningLatency::kRead);
+  ASSERT_EQ(1000U, window.count);
+  ASSERT_LE(window.p50, 10.0);
+  ASSERT_LE(window.p99, 10.0);
+
+  for (int i = 0; i < 980; i++) {
+    latency.Record(TuningLatency::kRead, 10);
+  }
+  for (int i = 0; i < 20; i++) {
+    latency.Record(TuningLatency::kRead, 10000);
+  }
+  window = latency.TakeWindow(TuningLatency::kRead);
+  ASSERT_GT(window.p99, 1000.0);
+}
+
+TEST_F(TuningLatencyTest, ConcurrentRecords) {
+  TuningLatency latency;
+  const int kThreads = 4;
+  const int kRecords = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&latency]() {
+      for (int i = 0; i < kRecords; i++) {
+        latency.Record(TuningLatency::kWrite, 10);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // the cores keep their own histograms, the window merges them
+  auto window = latency.TakeWindow(TuningLatency::kWrite);
+  ASSERT_LE(window.count, static_cast<uint64_t>(kThreads * kRecords));
+  ASSERT_GT(window.count, static_cast<uint64_t>(kThreads * kRecords * 9 / 10));
+  ASSERT_LE(window.p99, 10.0);
+  ASSERT_EQ(0U, latency.TakeWindow(TuningLatency::kWrite).count);
+}
+
+TEST_F(TuningLatencyTest, Timer) {
+  TuningLatency latency;
+  {
+    TuningLatencyTimer timer(SystemClock::Default().get(), &latency,
+                             TuningLatency::kWrite);
+  }
+  ASSERT_EQ(1U, latency.TakeWindow(TuningLatency::kWrite).count);
+  // no recorder, nothing to time
+  {
+    TuningLatencyTimer timer(SystemClock::Default().get(), nullptr,
+                             TuningLatency::kWrite);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
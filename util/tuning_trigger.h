@@ -0,0 +1,141 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Wakes the tuner as soon as the LSM runs into trouble instead of at its next
+// reporting tick. The producers are the WriteController (writes entering the
+// delayed or stopped state), the immutable memtable lists (the number of
+// unflushed memtables reaching the tuning threshold) and flush jobs (a flush
+// finished). Notify() is cheap and may be called with the DB mutex held.
+//
+// Events are rate limited: once a tuning round was triggered (or the regular
+// round ran, see MarkRound()), further events are held back for
+// `min_interval_micros` and then delivered as a single wakeup carrying all of
+// their reasons, so a burst of flushes does not make the tuner thrash.
+class TuningTrigger {
+ public:
+  enum Reason : uint32_t {
+    kNoReason = 0,
+    kWriteDelay = 1u << 0,
+    kWriteStop = 1u << 1,
+    kImmutableMemtables = 1u << 2,
+    kFlushCompleted = 1u << 3,
+  };
+
+  explicit TuningTrigger(uint64_t min_interval_micros)
+      : min_interval_(min_interval_micros),
+        pending_(kNoReason),
+        notifications_(0),
+        triggered_rounds_(0),
+        wakeups_(0) {}
+
+  TuningTrigger(const TuningTrigger&) = delete;
+  TuningTrigger& operator=(const TuningTrigger&) = delete;
+
+  // Thread safe, never blocks on the tuner.
+  void Notify(uint32_t reason) {
+    notifications_.fetch_add(1, std::memory_order_relaxed);
+    if (pending_.fetch_or(reason, std::memory_order_acq_rel) == kNoReason) {
+      // take the lock so that a waiter cannot miss the wakeup between its
+      // check of pending_ and its wait
+      std::lock_guard<std::mutex> lk(mu_);
+      cv_.notify_all();
+    }
+  }
+
+  // Blocks until a rate-limited event is due and returns its reasons.
+  // Returns kNoReason when `timeout_micros` passed first or WakeUp() was
+  // called.
+  uint32_t Wait(uint64_t timeout_micros) {
+    const auto deadline =
+        Clock::now() + std::chrono::microseconds(timeout_micros);
+    std::unique_lock<std::mutex> lk(mu_);
+    const uint64_t wakeups = wakeups_;
+    while (wakeups_ == wakeups) {
+      const auto now = Clock::now();
+      const bool pending =
+          pending_.load(std::memory_order_acquire) != kNoReason;
+      if (pending && now >= NextRoundLocked()) {
+        return FireLocked(now);
+      }
+      if (now >= deadline) {
+        break;
+      }
+      cv_.wait_until(lk, pending ? std::min(deadline, NextRoundLocked())
+                                 : deadline);
+    }
+    return kNoReason;
+  }
+
+  // Non-blocking Wait(), for tuners driven by a timer.
+  uint32_t Poll() {
+    std::lock_guard<std::mutex> lk(mu_);
+    const auto now = Clock::now();
+    if (pending_.load(std::memory_order_acquire) == kNoReason ||
+        now < NextRoundLocked()) {
+      return kNoReason;
+    }
+    return FireLocked(now);
+  }
+
+  // The regular tuning round ran and saw the state any pending event
+  // reported, restart the rate limit from now.
+  void MarkRound() {
+    std::lock_guard<std::mutex> lk(mu_);
+    pending_.store(kNoReason, std::memory_order_release);
+    last_round_ = Clock::now();
+  }
+
+  // Makes every current Wait() return kNoReason, used on shutdown.
+  void WakeUp() {
+    std::lock_guard<std::mutex> lk(mu_);
+    wakeups_++;
+    cv_.notify_all();
+  }
+
+  uint64_t Notifications() const {
+    return notifications_.load(std::memory_order_relaxed);
+  }
+  uint64_t TriggeredRounds() const {
+    return triggered_rounds_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  Clock::time_point NextRoundLocked() const {
+    return last_round_ + std::chrono::microseconds(min_interval_);
+  }
+
+  uint32_t FireLocked(Clock::time_point now) {
+    last_round_ = now;
+    triggered_rounds_.fetch_add(1, std::memory_order_relaxed);
+    return pending_.exchange(kNoReason, std::memory_order_acq_rel);
+  }
+
+  const uint64_t min_interval_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::atomic<uint32_t> pending_;
+  std::atomic<uint64_t> notifications_;
+  std::atomic<uint64_t> triggered_rounds_;
+  // guarded by mu_
+  Clock::time_point last_round_;
+  uint64_t wakeups_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,87 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/tuning_trigger.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "port/port.h"
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class TuningTriggerTest : public testing::Test {};
+
+TEST_F(TuningTriggerTest, TimeoutWithoutEvents) {
+  TuningTrigger trigger(0);
+  ASSERT_EQ(TuningTrigger::kNoReason, trigger.Poll());
+  ASSERT_EQ(TuningTrigger::kNoReason, trigger.Wait(1000));
+  ASSERT_EQ(0U, trigger.TriggeredRounds());
+}
+
+TEST_F(TuningTriggerTest, ReasonsAreCoalesced) {
+  TuningTrigger trigger(0);
+  trigger.Notify(TuningTrigger::kFlushCompleted);
+  trigger.Notify(TuningTrigger::kWriteDelay);
+  trigger.Notify(TuningTrigger::kFlushCompleted);
+  ASSERT_EQ(3U, trigger.Notifications());
+  ASSERT_EQ(TuningTrigger::kFlushCompleted | TuningTrigger::kWriteDelay,
+            trigger.Wait(1000));
+  ASSERT_EQ(TuningTrigger::kNoReason, trigger.Poll());
+  ASSERT_EQ(1U, trigger.TriggeredRounds());
+}
+
+TEST_F(TuningTriggerTest, RateLimited) {
+  // long enough not to elapse during the test
+  TuningTrigger trigger(60 * 1000 * 1000);
+  trigger.Notify(TuningTrigger::kWriteStop);
+  ASSERT_EQ(TuningTrigger::kWriteStop, trigger.Poll());
+
+  // held back until the interval passed
+  trigger.Notify(TuningTrigger::kImmutableMemtables);
+  ASSERT_EQ(TuningTrigger::kNoReason, trigger.Poll());
+  ASSERT_EQ(TuningTrigger::kNoReason, trigger.Wait(1000));
+  ASSERT_EQ(1U, trigger.TriggeredRounds());
+
+  // a regular round consumes the held event
+  trigger.MarkRound();
+  ASSERT_EQ(TuningTrigger::kNoReason, trigger.Poll());
+}
+
+TEST_F(TuningTriggerTest, NotifyWakesWaiter) {
+  TuningTrigger trigger(0);
+  std::atomic<uint32_t> reasons{TuningTrigger::kNoReason};
+  port::Thread waiter([&]() {
+    // far longer than the test may take
+    reasons.store(trigger.Wait(60 * 1000 * 1000));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  trigger.Notify(TuningTrigger::kWriteStop);
+  waiter.join();
+  ASSERT_EQ(TuningTrigger::kWriteStop, reasons.load());
+}
+
+TEST_F(TuningTriggerTest, WakeUp) {
+  TuningTrigger trigger(0);
+  std::atomic<bool> returned{false};
+  port::Thread waiter([&]() {
+    ASSERT_EQ(TuningTrigger::kNoReason, trigger.Wait(60 * 1000 * 1000));
+    returned.store(true);
+  });
+  while (!returned.load()) {
+    trigger.WakeUp();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  waiter.join();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Tells the workload phase of a DB from the keys it wrote, the keys it read
+// and the seeks it did, e.g. the NUMBER_KEYS_WRITTEN, NUMBER_KEYS_READ and
+// NUMBER_DB_SEEK tickers. The shares of the three are smoothed over the
+// rounds, and a new phase is only taken once it was seen kStableRounds rounds
+// in a row, so a single odd round does not flip the tuner's bounds. Rounds
+// without any operation keep the phase.
+// Not thread-safe, the tuner updates it once per round.
+class TuningWorkload {
+ public:
+  enum Phase : int {
+    kUnknown = 0,
+    kWriteHeavy,
+    kReadHeavy,
+    // Every seek touches all the levels, so scans weigh more than point reads
+    kScanHeavy,
+    kMixed,
+  };
+
+  static constexpr int kStableRounds = 2;
+  // the weight of the latest round in the smoothed shares
+  static constexpr double kSmoothing = 0.5;
+  static constexpr double kWriteHeavyShare = 0.7;
+  static constexpr double kReadHeavyShare = 0.7;
+  static constexpr double kScanHeavyShare = 0.3;
+
+  static const char* PhaseName(Phase phase) {
+    switch (phase) {
+      case kUnknown:
+        return "unknown";
+      case kWriteHeavy:
+        return "write-heavy";
+      case kReadHeavy:
+        return "read-heavy";
+      case kScanHeavy:
+        return "scan-heavy";
+      case kMixed:
+        return "mixed";
+    }
+    return "unknown";
+  }
+
+  // The arguments are running totals. Returns the phase after the round.
+  Phase Update(uint64_t keys_written, uint64_t keys_read, uint64_t seeks) {
+    const bool first = !started_;
+    const double writes = Delta(keys_written, &last_written_);
+    const double reads = Delta(keys_read, &last_read_);
+    const double scans = Delta(seeks, &last_seeks_);
+    started_ = true;
+    const double total = writes + reads + scans;
+    if (first || total == 0) {
+      return phase_;
+    }
+    if (!smoothed_) {
+      write_share_ = writes / total;
+      read_share_ = reads / total;
+      scan_share_ = scans / total;
+      smoothed_ = true;
+    } else {
+      write_share_ += kSmoothing * (writes / total - write_share_);
+      read_share_ += kSmoothing * (reads / total - read_share_);
+      scan_share_ += kSmoothing * (scans / total - scan_share_);
+    }
+
+    const Phase seen = Classify();
+    if (seen == phase_) {
+      candidate_rounds_ = 0;
+    } else if (seen == candidate_) {
+      if (++candidate_rounds_ >= kStableRounds) {
+        phase_ = seen;
+        candidate_rounds_ = 0;
+      }
+    } else {
+      candidate_ = seen;
+      candidate_rounds_ = 1;
+    }
+    return phase_;
+  }
+
+  // Start from `phase`, e.g. the phase of a DB before it was reopened.
+  void Resume(Phase phase) { phase_ = phase; }
+
+  Phase phase() const { return phase_; }
+  double write_share() const { return write_share_; }
+  double read_share() const { return read_share_; }
+  double scan_share() const { return scan_share_; }
+
+ private:
+  static double Delta(uint64_t total, uint64_t* last) {
+    const uint64_t delta = total > *last ? total - *last : 0;
+    *last = total;
+    return static_cast<double>(delta);
+  }
+
+  Phase Classify() const {
+    if (write_share_ >= kWriteHeavyShare) {
+      return kWriteHeavy;
+    }
+    if (scan_share_ >= kScanHeavyShare) {
+      return kScanHeavy;
+    }
+    if (read_share_ >= kReadHeavyShare) {
+      return kReadHeavy;
+    }
+    return kMixed;
+  }
+
+  bool started_ = false;
+  bool smoothed_ = false;
+  uint64_t last_written_ = 0;
+  uint64_t last_read_ = 0;
+  uint64_t last_seeks_ = 0;
+  double write_share_ = 0.0;
+  double read_share_ = 0.0;
+  double scan_share_ = 0.0;
+  Phase phase_ = kUnknown;
+  Phase candidate_ = kUnknown;
+  int candidate_rounds_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,79 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/tuning_workload.h"
+
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class TuningWorkloadTest : public testing::Test {
+ public:
+  // One round with the given operations.
+  TuningWorkload::Phase Round(TuningWorkload* workload, uint64_t writes,
+                              uint64_t reads, uint64_t seeks) {
+    written_ += writes;
+    read_ += reads;
+    seeks_ += seeks;
+    return workload->Update(written_, read_, seeks_);
+  }
+
+  uint64_t written_ = 0;
+  uint64_t read_ = 0;
+  uint64_t seeks_ = 0;
+};
+
+TEST_F(TuningWorkloadTest, Phases) {
+  struct Case {
+    uint64_t writes, reads, seeks;
+    TuningWorkload::Phase phase;
+  };
+  // YCSB load, C, E and A
+  for (const auto& c : {Case{1000, 0, 0, TuningWorkload::kWriteHeavy},
+                        Case{0, 1000, 0, TuningWorkload::kReadHeavy},
+                        Case{50, 0, 950, TuningWorkload::kScanHeavy},
+                        Case{500, 500, 0, TuningWorkload::kMixed}}) {
+    TuningWorkload workload;
+    written_ = read_ = seeks_ = 0;
+    // the first update only sets the base
+    ASSERT_EQ(TuningWorkload::kUnknown, Round(&workload, 1, 1, 1));
+    ASSERT_EQ(TuningWorkload::kUnknown,
+              Round(&workload, c.writes, c.reads, c.seeks));
+    ASSERT_EQ(c.phase, Round(&workload, c.writes, c.reads, c.seeks));
+  }
+}
+
+TEST_F(TuningWorkloadTest, SwitchesOnlyOnStablePhases) {
+  TuningWorkload workload;
+  Round(&workload, 0, 0, 0);
+  for (int i = 0; i < 5; i++) {
+    Round(&workload, 1000, 0, 0);
+  }
+  ASSERT_EQ(TuningWorkload::kWriteHeavy, workload.phase());
+
+  // a single read burst
+  ASSERT_EQ(TuningWorkload::kWriteHeavy, Round(&workload, 0, 10000, 0));
+  ASSERT_EQ(TuningWorkload::kWriteHeavy, Round(&workload, 1000, 0, 0));
+  // idle rounds keep the phase
+  ASSERT_EQ(TuningWorkload::kWriteHeavy, Round(&workload, 0, 0, 0));
+
+  // ingest turns into serving
+  TuningWorkload::Phase phase = workload.phase();
+  int rounds = 0;
+  while (phase != TuningWorkload::kReadHeavy && rounds < 10) {
+    phase = Round(&workload, 0, 1000, 0);
+    rounds++;
+  }
+  ASSERT_EQ(TuningWorkload::kReadHeavy, phase);
+  ASSERT_GE(rounds, TuningWorkload::kStableRounds);
+  ASSERT_GT(workload.read_share(), TuningWorkload::kReadHeavyShare);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
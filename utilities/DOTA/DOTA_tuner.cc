@@ -3,9 +3,16 @@
 //
 
 #include <algorithm>
+#include <limits>
+#include <set>
 #include <vector>
 
+#include "port/lang.h"
+#include "rocksdb/statistics.h"
+#include "rocksdb/table.h"
 #include "rocksdb/utilities/report_agent.h"
+#include "utilities/counted_fs.h"
+#include "utilities/DOTA/tuner_trace.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -74,67 +81,110 @@ BatchSizeStallLevels DOTA_Tuner::LocateBatchStates(SystemScores &score) {
 };
 
 SystemScores DOTA_Tuner::ScoreTheSystem() {
+  if (replay_input_ != nullptr) {
+    return ReplayRoundInputs();
+  }
   UpdateSystemStats();
   SystemScores current_score;
 
-  uint64_t total_mem_size = 0;
-  uint64_t active_mem = 0;
-  running_db_->GetIntProperty("rocksdb.size-all-mem-tables", &total_mem_size);
-  running_db_->GetIntProperty("rocksdb.cur-size-active-mem-table", &active_mem);
-
-  current_score.active_size_ratio =
-      (double)active_mem / (double)current_opt.write_buffer_size;
-  current_score.immutable_number =
-      cfd->imm() == nullptr ? 0 : cfd->imm()->NumNotFlushed();
-
-  std::vector<FlushMetrics> flush_metric_list;
-
-  auto flush_result_length =
-      running_db_->immutable_db_options().flush_stats->size();
-
-
-  auto compaction_result_length =
-      running_db_->immutable_db_options().job_stats->size();
-
-  for (uint64_t i = flush_list_accessed; i < flush_result_length; i++) {
-    auto temp = flush_list_from_opt_ptr->at(i);
-    current_score.flush_min =
-        std::min(current_score.flush_speed_avg, current_score.flush_min);
-    flush_metric_list.push_back(temp);
-    current_score.flush_speed_avg += temp.write_out_bandwidth;
-    current_score.disk_bandwidth += temp.total_bytes;
-    last_non_zero_flush = temp.write_out_bandwidth;
-    if (current_score.l0_num > temp.l0_files) {
-      current_score.l0_num = temp.l0_files;
-    }
+  // Rounds woken by the TuningTrigger are shorter than the gap, so the rates
+  // are taken over the time that really passed.
+  const uint64_t now_micros = env_->NowMicros();
+  const bool first_round = last_score_micros_ == 0;
+  double round_secs = tuning_gap;
+  if (!first_round && now_micros > last_score_micros_) {
+    round_secs =
+        static_cast<double>(now_micros - last_score_micros_) / kMicrosInSecond;
+  }
+  last_score_micros_ = now_micros;
+
+  // Throughput and write stalls of the round, ARK judges its last change by
+  // them. Without a reporter counting the operations, the written keys are
+  // the throughput.
+  auto *internal_stats = running_db_->GetVersionSet()
+                             ->GetColumnFamilySet()
+                             ->GetDefault()
+                             ->internal_stats();
+  const uint64_t ops_done =
+      total_ops_done_ptr_ != nullptr
+          ? static_cast<uint64_t>(total_ops_done_ptr_->load())
+          : internal_stats->GetDBStats(InternalStats::kIntStatsNumKeysWritten);
+  const uint64_t stall_micros =
+      internal_stats->GetDBStats(InternalStats::kIntStatsWriteStallMicros);
+  if (!first_round) {
+    current_score.interval_qps =
+        ops_done > last_ops_done_ ? (ops_done - last_ops_done_) / round_secs
+                                  : 0.0;
+    current_score.stall_ratio =
+        stall_micros > last_stall_micros_
+            ? std::min(1.0, (stall_micros - last_stall_micros_) /
+                                (round_secs * kMicrosInSecond))
+            : 0.0;
   }
+  last_ops_done_ = ops_done;
+  last_stall_micros_ = stall_micros;
+  const auto &latency = running_db_->immutable_db_options().tuning_latency;
+  if (latency != nullptr) {
+    current_score.write_latency_p99 =
+        latency->TakeWindow(TuningLatency::kWrite).p99;
+    current_score.read_latency_p99 =
+        latency->TakeWindow(TuningLatency::kRead).p99;
+  }
+  const auto &statistics = running_db_->immutable_db_options().statistics;
+  if (statistics != nullptr) {
+    workload_phase_ =
+        workload_.Update(statistics->getTickerCount(NUMBER_KEYS_WRITTEN),
+                         statistics->getTickerCount(NUMBER_KEYS_READ),
+                         statistics->getTickerCount(NUMBER_DB_SEEK));
+  }
+
+  uint64_t total_mem_size = snapshot_.memtable_bytes;
+  // active_size_ratio, immutable_number, l0_num and
+  // estimate_compaction_bytes come from the worst column family
+  ScoreColumnFamilies(&current_score);
+
+  // Both rings are consumed through their cursors; records that were
+  // overwritten before this round are simply skipped.
+  flush_metric_list.clear();
+  flush_list_from_opt_ptr->ConsumeSince(
+      &flush_list_accessed, [&](const FlushMetrics &temp) {
+        current_score.flush_min =
+            std::min(current_score.flush_speed_avg, current_score.flush_min);
+        flush_metric_list.push_back(temp);
+        current_score.flush_speed_avg += temp.write_out_bandwidth;
+        current_score.disk_bandwidth += temp.total_bytes;
+        last_non_zero_flush = temp.write_out_bandwidth;
+        auto cf_state = cf_states_.find(temp.cf_id);
+        if (cf_state != cf_states_.end()) {
+          cf_state->second.flush_numbers++;
+        }
+      });
   int l0_compaction = 0;
-  auto num_new_flushes = (flush_result_length - flush_list_accessed);
-  current_score.flush_numbers = num_new_flushes;
+  auto num_new_flushes = flush_metric_list.size();
+  current_score.flush_numbers = static_cast<int>(num_new_flushes);
 
   while (total_mem_size < last_unflushed_bytes) {
     total_mem_size += current_opt.write_buffer_size;
   }
   current_score.memtable_speed += (total_mem_size - last_unflushed_bytes);
 
-  current_score.memtable_speed /= tuning_gap;
+  current_score.memtable_speed /= round_secs;
   current_score.memtable_speed /= kMicrosInSecond;  // we use MiB to calculate
 
   uint64_t max_pending_bytes = 0;
 
   last_unflushed_bytes = total_mem_size;
-  for (uint64_t i = compaction_list_accessed; i < compaction_result_length;
-       i++) {
-    auto temp = compaction_list_from_opt_ptr->at(i);
-    if (temp.input_level == 0) {
-      current_score.l0_drop_ratio += temp.drop_ratio;
-      l0_compaction++;
-    }
-    if (temp.current_pending_bytes > max_pending_bytes) {
-      max_pending_bytes = temp.current_pending_bytes;
-    }
-    current_score.disk_bandwidth += temp.total_bytes;
-  }
+  compaction_list_from_opt_ptr->ConsumeSince(
+      &compaction_list_accessed, [&](const QuicksandMetrics &temp) {
+        if (temp.input_level == 0) {
+          current_score.l0_drop_ratio += temp.drop_ratio;
+          l0_compaction++;
+        }
+        if (temp.current_pending_bytes > max_pending_bytes) {
+          max_pending_bytes = temp.current_pending_bytes;
+        }
+        current_score.disk_bandwidth += temp.total_bytes;
+      });
 
   // flush_speed_avg,flush_speed_var,l0_drop_ratio
   if (num_new_flushes != 0) {
@@ -151,48 +201,324 @@ SystemScores DOTA_Tuner::ScoreTheSystem() {
   if (l0_compaction != 0) {
     current_score.l0_drop_ratio /= l0_compaction;
   }
-  // l0_num
-
-  current_score.l0_num = (double)(vfs->NumLevelFiles(vfs->base_level())) /
-                         current_opt.level0_slowdown_writes_trigger;
-  //std::cout << "currenct score, l0 number" << current_score.l0_num <<std::endl;
-  //  current_score.l0_num = l0_compaction == 0 ? current_score.l0_num : 0;
-  // disk bandwidth,estimate_pending_bytes ratio
+  // disk bandwidth
   current_score.disk_bandwidth /= kMicrosInSecond;
 
-  current_score.estimate_compaction_bytes =
-      (double)vfs->estimated_compaction_needed_bytes() /
-      current_opt.soft_pending_compaction_bytes_limit;
-
-  auto flush_thread_idle_list = *env_->GetThreadPoolWaitingTime(Env::HIGH);
-  auto compaction_thread_idle_list = *env_->GetThreadPoolWaitingTime(Env::LOW);
-  std::unordered_map<int, uint64_t> thread_idle_time;
-  uint64_t temp = flush_thread_idle_list.size();
-  for (uint64_t i = last_flush_thread_len; i < temp; i++) {
-    auto temp_entry = flush_thread_idle_list[i];
-    auto value = temp_entry.second;
-    current_score.flush_idle_time += value;
-  }
-  temp = compaction_thread_idle_list.size();
-  for (uint64_t i = last_compaction_thread_len; i < temp; i++) {
-    auto temp_entry = compaction_thread_idle_list[i];
-    auto value = temp_entry.second;
-    current_score.compaction_idle_time += value;
-  }
+  current_score.flush_idle_time += static_cast<double>(
+      env_->GetThreadPoolWaitingTime(Env::HIGH, &last_flush_thread_len));
+  current_score.compaction_idle_time += static_cast<double>(
+      env_->GetThreadPoolWaitingTime(Env::LOW, &last_compaction_thread_len));
   current_score.flush_idle_time /=
       (current_opt.max_background_jobs * kMicrosInSecond / 4);
   // flush threads always get 1/4 of all
   current_score.compaction_idle_time /=
       (current_opt.max_background_jobs * kMicrosInSecond * 3 / 4);
+  // the thresholds are calibrated for full-gap rounds
+  current_score.flush_idle_time *= tuning_gap / round_secs;
+  current_score.compaction_idle_time *= tuning_gap / round_secs;
+
+  // The device bandwidth is only learned from rounds in which background
+  // work was waiting for it.
+  const auto &tuning_fs = running_db_->immutable_db_options().tuning_fs;
+  if (tuning_fs != nullptr) {
+    const bool busy = snapshot_.write_delayed || snapshot_.write_stopped ||
+                      current_score.immutable_number >= 1 ||
+                      current_score.estimate_compaction_bytes >= 1.0;
+    current_score.io_utilization =
+        bandwidth_
+            .Update(tuning_fs->counters()->writes.bytes.load(),
+                    tuning_fs->counters()->reads.bytes.load(), round_secs,
+                    busy)
+            .utilization;
+  }
 
-  // clean up
-  flush_list_accessed = flush_result_length;
-  compaction_list_accessed = compaction_result_length;
-  last_compaction_thread_len = compaction_thread_idle_list.size();
-  last_flush_thread_len = flush_thread_idle_list.size();
+  if (trace_record_ != nullptr) {
+    RecordRoundInputs(current_score);
+  }
   return current_score;
 }
 
+void DOTA_Tuner::RecordRoundInputs(const SystemScores &score) {
+  trace_record_->scores = score;
+  trace_record_->cf_states.clear();
+  for (const auto &entry : cf_states_) {
+    trace_record_->cf_states.push_back(entry.second);
+  }
+  trace_record_->flush_threads = current_flush_threads_;
+  trace_record_->compaction_threads = current_compaction_threads_;
+  trace_record_->max_background_jobs = current_opt.max_background_jobs;
+  trace_record_->write_buffer_size = current_opt.write_buffer_size;
+  trace_record_->memtable_budget = MemtableBudget();
+  trace_record_->apply_micros = last_apply_micros_;
+  trace_record_->rate_limit = rate_limit_;
+  trace_record_->workload_phase = workload_phase_;
+}
+
+SystemScores DOTA_Tuner::ReplayRoundInputs() {
+  const TunerTraceRecord &input = *replay_input_;
+  current_opt.max_background_jobs = input.max_background_jobs;
+  current_opt.write_buffer_size = input.write_buffer_size;
+  current_flush_threads_ = input.flush_threads;
+  current_compaction_threads_ = input.compaction_threads;
+  last_apply_micros_ = input.apply_micros;
+  rate_limit_ = input.rate_limit;
+  workload_phase_ = input.workload_phase;
+  // the scores and options are the traced ones, the ARK history of every
+  // column family is the replaying tuner's own
+  std::map<uint32_t, ColumnFamilyTuningState> states;
+  for (const auto &traced : input.cf_states) {
+    auto &state = states[traced.id];
+    auto prev = cf_states_.find(traced.id);
+    state = prev != cf_states_.end() ? prev->second : ColumnFamilyTuningState();
+    state.id = traced.id;
+    state.name = traced.name;
+    state.active_size_ratio = traced.active_size_ratio;
+    state.immutable_number = traced.immutable_number;
+    state.l0_num = traced.l0_num;
+    state.estimate_compaction_bytes = traced.estimate_compaction_bytes;
+    state.flush_numbers = traced.flush_numbers;
+    state.write_buffer_size = traced.write_buffer_size;
+    state.target_file_size_base = traced.target_file_size_base;
+    state.max_write_buffer_number = traced.max_write_buffer_number;
+    state.min_write_buffer_number_to_merge =
+        traced.min_write_buffer_number_to_merge;
+    state.level0_file_num_compaction_trigger =
+        traced.level0_file_num_compaction_trigger;
+    state.level0_slowdown_writes_trigger =
+        traced.level0_slowdown_writes_trigger;
+    state.level0_stop_writes_trigger = traced.level0_stop_writes_trigger;
+    state.soft_pending_compaction_bytes_limit =
+        traced.soft_pending_compaction_bytes_limit;
+    state.hard_pending_compaction_bytes_limit =
+        traced.hard_pending_compaction_bytes_limit;
+    state.base_level0_slowdown_writes_trigger =
+        traced.base_level0_slowdown_writes_trigger;
+    state.base_level0_stop_writes_trigger =
+        traced.base_level0_stop_writes_trigger;
+    state.base_soft_pending_compaction_bytes_limit =
+        traced.base_soft_pending_compaction_bytes_limit;
+    state.base_hard_pending_compaction_bytes_limit =
+        traced.base_hard_pending_compaction_bytes_limit;
+    state.max_compactions_per_output_level =
+        traced.max_compactions_per_output_level;
+    state.num_levels = traced.num_levels;
+    state.base_level = traced.base_level;
+  }
+  cf_states_.swap(states);
+  if (trace_record_ != nullptr) {
+    RecordRoundInputs(input.scores);
+  }
+  return input.scores;
+}
+
+void DOTA_Tuner::ScoreColumnFamilies(SystemScores *score) {
+  std::map<uint32_t, ColumnFamilyTuningState> states;
+  std::set<const Cache *> block_caches;
+  block_cache_bytes_ = 0;
+  {
+    InstrumentedMutexLock l(running_db_->mutex());
+    for (auto *cf : *running_db_->GetVersionSet()->GetColumnFamilySet()) {
+      if (cf->IsDropped() || !cf->initialized() ||
+          cf->GetName() == kPersistentStatsColumnFamilyName) {
+        continue;
+      }
+      // column families often share one block cache
+      const auto &table_factory = cf->ioptions()->table_factory;
+      const auto *table_options =
+          table_factory != nullptr
+              ? table_factory->GetOptions<BlockBasedTableOptions>()
+              : nullptr;
+      if (table_options != nullptr && !table_options->no_block_cache &&
+          table_options->block_cache != nullptr &&
+          block_caches.insert(table_options->block_cache.get()).second) {
+        block_cache_bytes_ += table_options->block_cache->GetCapacity();
+      }
+      auto &state = states[cf->GetID()];
+      auto prev = cf_states_.find(cf->GetID());
+      if (prev != cf_states_.end()) {
+        state = prev->second;
+      }
+      const MutableCFOptions *opts = cf->GetLatestMutableCFOptions();
+      const VersionStorageInfo *vstorage = cf->current()->storage_info();
+      state.id = cf->GetID();
+      state.name = cf->GetName();
+      state.write_buffer_size = opts->write_buffer_size;
+      state.target_file_size_base = opts->target_file_size_base;
+      state.max_write_buffer_number = opts->max_write_buffer_number;
+      state.min_write_buffer_number_to_merge =
+          opts->min_write_buffer_number_to_merge;
+      state.level0_file_num_compaction_trigger =
+          opts->level0_file_num_compaction_trigger;
+      state.level0_slowdown_writes_trigger =
+          opts->level0_slowdown_writes_trigger;
+      state.level0_stop_writes_trigger = opts->level0_stop_writes_trigger;
+      state.soft_pending_compaction_bytes_limit =
+          opts->soft_pending_compaction_bytes_limit;
+      state.hard_pending_compaction_bytes_limit =
+          opts->hard_pending_compaction_bytes_limit;
+      state.max_compactions_per_output_level =
+          opts->max_compactions_per_output_level;
+      state.num_levels = vstorage->num_levels();
+      state.base_level = vstorage->base_level();
+      // ARK raises the stall limits, the scores keep their meaning
+      if (prev == cf_states_.end()) {
+        state.base_level0_slowdown_writes_trigger =
+            opts->level0_slowdown_writes_trigger;
+        state.base_level0_stop_writes_trigger =
+            opts->level0_stop_writes_trigger;
+        state.base_soft_pending_compaction_bytes_limit =
+            opts->soft_pending_compaction_bytes_limit;
+        state.base_hard_pending_compaction_bytes_limit =
+            opts->hard_pending_compaction_bytes_limit;
+      }
+
+      state.active_size_ratio = (double)cf->mem()->ApproximateMemoryUsage() /
+                                (double)opts->write_buffer_size;
+      state.immutable_number = cf->imm()->NumNotFlushed();
+      state.l0_num = (double)(vstorage->NumLevelFiles(vstorage->base_level())) /
+                     state.base_level0_slowdown_writes_trigger;
+      // without a soft pending bytes limit the pending bytes never stall
+      state.estimate_compaction_bytes =
+          state.base_soft_pending_compaction_bytes_limit > 0
+              ? (double)vstorage->estimated_compaction_needed_bytes() /
+                    state.base_soft_pending_compaction_bytes_limit
+              : 0.0;
+      state.flush_numbers = 0;
+    }
+  }
+  cf_states_.swap(states);
+
+  for (const auto &entry : cf_states_) {
+    const auto &state = entry.second;
+    score->active_size_ratio =
+        std::max(score->active_size_ratio, state.active_size_ratio);
+    score->immutable_number =
+        std::max(score->immutable_number, state.immutable_number);
+    score->l0_num = std::max(score->l0_num, state.l0_num);
+    score->estimate_compaction_bytes = std::max(
+        score->estimate_compaction_bytes, state.estimate_compaction_bytes);
+  }
+}
+
+uint64_t DOTA_Tuner::MemtableBudget() const {
+  if (replay_input_ != nullptr) {
+    return replay_input_->memtable_budget;
+  }
+  const auto &db_options = running_db_->immutable_db_options();
+  const auto *write_buffer_manager = db_options.write_buffer_manager.get();
+  uint64_t budget = db_options.db_write_buffer_size;
+  if (write_buffer_manager != nullptr && write_buffer_manager->enabled()) {
+    budget = write_buffer_manager->buffer_size();
+  }
+  if (db_options.tuning_memory_budget > 0) {
+    // Memtables charged to the block cache are part of its capacity already.
+    const uint64_t cache_bytes = write_buffer_manager != nullptr &&
+                                         write_buffer_manager->cost_to_cache()
+                                     ? 0
+                                     : block_cache_bytes_;
+    // Even without any room left a budget is kept, so the memtables shrink
+    // to their minimum rather than grow.
+    const uint64_t left = db_options.tuning_memory_budget > cache_bytes
+                              ? db_options.tuning_memory_budget - cache_bytes
+                              : 1;
+    budget = budget == 0 ? left : std::min(budget, left);
+  }
+  return budget;
+}
+
+DOTA_Tuner::PhaseBounds DOTA_Tuner::PhaseBoundsFor(
+    TuningWorkload::Phase phase) const {
+  PhaseBounds bounds;
+  bounds.min_memtable_size = min_memtable_size;
+  bounds.max_memtable_size = max_memtable_size;
+  bounds.min_sstable_size = min_sstable_size;
+  bounds.min_compaction_threads = 1;
+  bounds.max_compaction_threads = max_thread;
+  bounds.l0_pressure_threshold = 1.0;
+  switch (phase) {
+    case TuningWorkload::kWriteHeavy:
+      bounds.min_memtable_size =
+          std::min(std::max(min_memtable_size,
+                            2 * static_cast<uint64_t>(
+                                    default_opts.write_buffer_size)),
+                   max_memtable_size);
+      bounds.max_compaction_threads = std::max(1, max_thread / 2);
+      break;
+    case TuningWorkload::kScanHeavy:
+      bounds.min_sstable_size =
+          std::min(std::max(min_sstable_size,
+                            2 * default_opts.target_file_size_base),
+                   max_sstable_size);
+      FALLTHROUGH_INTENDED;
+    case TuningWorkload::kReadHeavy:
+      bounds.max_memtable_size =
+          std::min(std::max(min_memtable_size,
+                            static_cast<uint64_t>(
+                                default_opts.write_buffer_size)),
+                   max_memtable_size);
+      bounds.min_compaction_threads =
+          std::min(std::max(2, max_thread / 2), max_thread);
+      bounds.l0_pressure_threshold = 0.5;
+      break;
+    case TuningWorkload::kMixed:
+    case TuningWorkload::kUnknown:
+      break;
+  }
+  return bounds;
+}
+
+void DOTA_Tuner::ShareMemtableBudget(
+    std::map<uint32_t, uint64_t> *memtable_targets,
+    std::map<uint32_t, int> *slot_targets) {
+  const uint64_t budget = MemtableBudget();
+  if (budget == 0 || memtable_targets->empty()) {
+    return;
+  }
+  auto total_memory = [&]() {
+    uint64_t total = 0;
+    for (const auto &target : *memtable_targets) {
+      total += target.second * std::max(1, (*slot_targets)[target.first]);
+    }
+    return total;
+  };
+
+  // no new slots without the memory for them
+  if (total_memory() > budget) {
+    for (auto &slots : *slot_targets) {
+      slots.second = std::min(slots.second,
+                              cf_states_[slots.first].max_write_buffer_number);
+    }
+  }
+  // take memory back from the column families that do not need it
+  bool shrunk = true;
+  while (total_memory() > budget && shrunk) {
+    shrunk = false;
+    for (auto &target : *memtable_targets) {
+      if (!cf_states_[target.first].memtable_pressure &&
+          target.second > min_memtable_size) {
+        target.second = std::max(target.second / 2, min_memtable_size);
+        shrunk = true;
+      }
+    }
+  }
+  // still too much, scale everyone down
+  const uint64_t total = total_memory();
+  if (total > budget) {
+    const double ratio = static_cast<double>(budget) / total;
+    for (auto &target : *memtable_targets) {
+      target.second = std::max(
+          static_cast<uint64_t>(target.second * ratio), min_memtable_size);
+    }
+  }
+  // the minimum sizes may not fit either, then nothing grows
+  if (total_memory() > budget) {
+    for (auto &target : *memtable_targets) {
+      target.second =
+          std::min(target.second, cf_states_[target.first].write_buffer_size);
+    }
+  }
+}
+
 void DOTA_Tuner::AdjustmentTuning(std::vector<ChangePoint> *change_list,
                                   SystemScores &score,
                                   ThreadStallLevels thread_levels,
@@ -251,7 +577,9 @@ inline void DOTA_Tuner::SetThreadNum(std::vector<ChangePoint> *change_list,
 
 inline void DOTA_Tuner::SetBatchSize(std::vector<ChangePoint> *change_list,
                                      uint64_t memtable_target,
-                                     uint64_t sstable_value) {
+                                     uint64_t sstable_value,
+                                     const ColumnFamilyTuningState *cf,
+                                     int merge_value) {
   ChangePoint memtable_size_cp;
   ChangePoint L1_total_size;
   ChangePoint sst_size_cp;
@@ -275,13 +603,24 @@ inline void DOTA_Tuner::SetBatchSize(std::vector<ChangePoint> *change_list,
   sst_size_cp.value = std::to_string(sstable_target);
 
   // calculate the total size of L1
-  uint64_t l1_size = current_opt.level0_file_num_compaction_trigger *
-                     current_opt.min_write_buffer_number_to_merge *
-                     memtable_target;
+  const int l0_trigger = cf != nullptr
+                             ? cf->level0_file_num_compaction_trigger
+                             : current_opt.level0_file_num_compaction_trigger;
+  int to_merge = cf != nullptr ? cf->min_write_buffer_number_to_merge
+                               : current_opt.min_write_buffer_number_to_merge;
+  if (merge_value > 0) {
+    to_merge = merge_value;
+  }
+  uint64_t l1_size = l0_trigger * to_merge * memtable_target;
 
   L1_total_size.value = std::to_string(l1_size);
   sst_size_cp.db_width = false;
   L1_total_size.db_width = false;
+  if (cf != nullptr) {
+    memtable_size_cp.cf_id = cf->id;
+    L1_total_size.cf_id = cf->id;
+    sst_size_cp.cf_id = cf->id;
+  }
 
   //  change_list->push_back(write_buffer_number);
   change_list->push_back(memtable_size_cp);
@@ -291,6 +630,10 @@ inline void DOTA_Tuner::SetBatchSize(std::vector<ChangePoint> *change_list,
 
 void DOTA_Tuner::FillUpChangeList(std::vector<ChangePoint> *change_list,
                                   TuningOP op) {
+  if (trace_record_ != nullptr) {
+    trace_record_->decided = true;
+    trace_record_->op = op;
+  }
   uint64_t current_thread_num = current_opt.max_background_jobs;
   uint64_t current_batch_size = current_opt.write_buffer_size;
   switch (op.BatchOp) {
@@ -334,6 +677,11 @@ SystemScores SystemScores::operator-(const SystemScores &a) {
   temp.flush_idle_time = this->flush_idle_time - a.flush_idle_time;
   temp.flush_gap_time = this->flush_gap_time - a.flush_gap_time;
   temp.flush_numbers = this->flush_numbers - a.flush_numbers;
+  temp.interval_qps = this->interval_qps - a.interval_qps;
+  temp.stall_ratio = this->stall_ratio - a.stall_ratio;
+  temp.write_latency_p99 = this->write_latency_p99 - a.write_latency_p99;
+  temp.read_latency_p99 = this->read_latency_p99 - a.read_latency_p99;
+  temp.io_utilization = this->io_utilization - a.io_utilization;
 
   return temp;
 }
@@ -355,6 +703,11 @@ SystemScores SystemScores::operator+(const SystemScores &a) {
       this->compaction_idle_time + a.compaction_idle_time;
   temp.flush_idle_time = this->flush_idle_time + a.flush_idle_time;
   temp.flush_gap_time = this->flush_gap_time + a.flush_gap_time;
+  temp.interval_qps = this->interval_qps + a.interval_qps;
+  temp.stall_ratio = this->stall_ratio + a.stall_ratio;
+  temp.write_latency_p99 = this->write_latency_p99 + a.write_latency_p99;
+  temp.read_latency_p99 = this->read_latency_p99 + a.read_latency_p99;
+  temp.io_utilization = this->io_utilization + a.io_utilization;
   return temp;
 }
 
@@ -370,6 +723,11 @@ SystemScores SystemScores::operator/(const int &a) {
   temp.disk_bandwidth = this->disk_bandwidth / a;
   temp.compaction_idle_time = this->compaction_idle_time / a;
   temp.flush_idle_time = this->flush_idle_time / a;
+  temp.interval_qps = this->interval_qps / a;
+  temp.stall_ratio = this->stall_ratio / a;
+  temp.write_latency_p99 = this->write_latency_p99 / a;
+  temp.read_latency_p99 = this->read_latency_p99 / a;
+  temp.io_utilization = this->io_utilization / a;
 
   temp.flush_speed_avg = this->flush_numbers == 0
                              ? 0
@@ -383,16 +741,131 @@ SystemScores SystemScores::operator/(const int &a) {
   return temp;
 }
 
+namespace {
+Options TunerReplayOptions(const TunerTraceHeader &header) {
+  Options opt;
+  opt.core_number = header.core_number;
+  opt.max_memtable_size = header.max_memtable_size;
+  opt.write_buffer_size = header.write_buffer_size;
+  opt.target_file_size_base = header.target_file_size_base;
+  opt.max_background_jobs = header.max_background_jobs;
+  opt.max_background_flushes = header.max_background_flushes;
+  opt.max_background_compactions = header.max_background_compactions;
+  opt.tuning_objective = header.objective;
+  if (header.rate_limit_bytes_per_sec > 0) {
+    opt.rate_limiter.reset(
+        NewGenericRateLimiter(static_cast<int64_t>(
+            header.rate_limit_bytes_per_sec)));
+  }
+  return opt;
+}
+}  // namespace
+
+FEAT_Tuner::FEAT_Tuner(const TunerTraceHeader &header, Env *env,
+                       std::shared_ptr<TuningPolicy> policy)
+    : DOTA_Tuner(TunerReplayOptions(header), env, header.tuning_gap),
+      policy_(std::move(policy)),
+      current_stage(kSlowStart) {}
+
 FEAT_Tuner::~FEAT_Tuner() = default;
 
-void FEAT_Tuner::DetectTuningOperations(int /*secs_elapsed*/,
+void FEAT_Tuner::DetectTuningOperations(int secs_elapsed,
                                         std::vector<ChangePoint> *change_list) {
+  if (policy_ == nullptr) {
+    return;
+  }
+  if (resume_state_ != nullptr && running_db_ != nullptr) {
+    // the policy decides from the resumed options, next round
+    ResumeRound(change_list);
+    resume_state_.reset();
+    state_changed_ = !change_list->empty();
+    return;
+  }
+  const size_t first_point = change_list->size();
+  const bool save = state_changed_ || ++rounds_since_save_ >= kSaveStateRounds;
+  if (trace_writer_ == nullptr) {
+    policy_->DetectTuningOperations(this, secs_elapsed, change_list);
+  } else {
+    TunerTraceRecord record;
+    TraceRound(secs_elapsed, change_list, &record);
+    Status s = trace_writer_->Write(record);
+    if (!s.ok()) {
+      std::cout << "stop tracing the tuner: " << s.ToString() << std::endl;
+      trace_writer_.reset();
+    }
+  }
+  // the options of this round's changes are seen, and saved, next round
+  state_changed_ = change_list->size() > first_point;
+  if (save) {
+    Status s = SaveState();
+    if (!s.ok()) {
+      std::cout << "can't save the tuner state: " << s.ToString() << std::endl;
+    }
+  }
+}
+
+void FEAT_Tuner::TraceRound(int secs_elapsed,
+                            std::vector<ChangePoint> *change_list,
+                            TunerTraceRecord *record) {
+  const size_t first_point = change_list->size();
+  record->secs_elapsed = secs_elapsed;
+  record->before = GetArkCounters();
+  trace_record_ = record;
+  policy_->DetectTuningOperations(this, secs_elapsed, change_list);
+  trace_record_ = nullptr;
+  record->after = GetArkCounters();
+  record->change_points.assign(change_list->begin() + first_point,
+                               change_list->end());
+}
+
+Status FEAT_Tuner::StartTrace(Env *env, const std::string &path) {
+  TunerTraceHeader header;
+  header.policy = policy_ != nullptr ? policy_->GetId() : std::string();
+  header.tuning_gap = static_cast<uint64_t>(tuning_gap);
+  header.core_number = static_cast<uint64_t>(core_num);
+  header.max_memtable_size = max_memtable_size;
+  header.write_buffer_size = default_opts.write_buffer_size;
+  header.target_file_size_base = default_opts.target_file_size_base;
+  header.max_background_jobs = default_opts.max_background_jobs;
+  header.max_background_flushes = default_opts.max_background_flushes;
+  header.max_background_compactions = default_opts.max_background_compactions;
+  header.objective = objective_;
+  header.rate_limit_bytes_per_sec = default_rate_limit_;
+  std::unique_ptr<TunerTraceWriter> writer;
+  Status s = TunerTraceWriter::Create(env, path, header, &writer);
+  if (s.ok()) {
+    trace_writer_ = std::move(writer);
+  }
+  return s;
+}
+
+void FEAT_Tuner::ReplayRound(const TunerTraceRecord &input,
+                             TunerTraceRecord *output) {
+  std::vector<ChangePoint> change_list;
+  replay_input_ = &input;
+  if (policy_ != nullptr) {
+    TraceRound(input.secs_elapsed, &change_list, output);
+  }
+  replay_input_ = nullptr;
+}
+
+ArkCounters FEAT_Tuner::GetArkCounters() const {
+  ArkCounters counters;
+  counters.memtable_pressure_score = memtable_pressure_score_;
+  counters.compaction_pressure_score = compaction_pressure_score_;
+  counters.memtable_relax_counter = memtable_relax_counter_;
+  counters.compaction_relax_counter = compaction_relax_counter_;
+  counters.stall_suspect_counter = stall_suspect_counter_;
+  return counters;
+}
+
+bool FEAT_Tuner::ScoreRound() {
   //   first, we tune only when the flushing speed is slower than before
   auto current_score = this->ScoreTheSystem();
-  if (current_score.flush_speed_avg == 0) return;
+  if (current_score.flush_speed_avg == 0) return false;
   scores.push_back(current_score);
   if (scores.size() == 1) {
-    return;
+    return false;
   }
   this->UpdateMaxScore(current_score);
   if (scores.size() >= (size_t)this->score_array_len) {
@@ -412,26 +885,8 @@ void FEAT_Tuner::DetectTuningOperations(int /*secs_elapsed*/,
 
    //<=avg_scores.memtable_speed * TEA_slow_flush) {
 
-  if (current_score_.flush_speed_avg <= 0) {
-    return;
-  }
-
-  if (ark_enable) {
-    TuningOP ark_result = TuneByArk();
-    FillUpChangeListArk(change_list, ark_result);
-    return;
-  }
-
-  TuningOP result{kKeep, kKeep};
-  if (TEA_enable) {
-    result = TuneByTEA();
-  }
-  if (FEA_enable) {
-    TuningOP fea_result = TuneByFEA();
-    result.BatchOp = fea_result.BatchOp;
-  }
-  FillUpChangeList(change_list, result);
- }
+  return current_score_.flush_speed_avg > 0;
+}
 
 SystemScores FEAT_Tuner::normalize(SystemScores &origin_score) {
   return origin_score;
@@ -439,6 +894,38 @@ SystemScores FEAT_Tuner::normalize(SystemScores &origin_score) {
 
 
 
+namespace {
+// A flush backlog is cheaper to absorb with one more immutable memtable than
+// with a larger memtable, and is flushed as soon as a memtable is full. An L0
+// backlog merges more memtables per flush, into fewer L0 files. Once the
+// memtables relaxed the slots are given back.
+void SlotOps(bool flush_backlog, bool l0_pressure, bool memtable_relaxed,
+             OpType *write_buffer_number_op, OpType *merge_width_op) {
+  *write_buffer_number_op = kKeep;
+  *merge_width_op = kKeep;
+  if (flush_backlog) {
+    *write_buffer_number_op = kLinearIncrease;
+    *merge_width_op = kHalf;
+  } else if (memtable_relaxed) {
+    *write_buffer_number_op = kHalf;
+  }
+  if (!flush_backlog && l0_pressure) {
+    *merge_width_op = kLinearIncrease;
+  }
+}
+
+// ARK caps every level below the base level alike, so the cap of the last
+// level is the one in use, 0 for no cap.
+int DeepCompactionLimit(const ColumnFamilyTuningState &cf) {
+  const auto &limits = cf.max_compactions_per_output_level;
+  const int last = cf.num_levels - 1;
+  if (last < 0 || last >= static_cast<int>(limits.size())) {
+    return 0;
+  }
+  return std::max(limits[last], 0);
+}
+}  // namespace
+
 TuningOP FEAT_Tuner::TuneByArk() {
   TuningOP result{kKeep, kKeep, kKeep, kKeep};
 
@@ -454,9 +941,11 @@ TuningOP FEAT_Tuner::TuneByArk() {
   const bool high_active_ratio = current_score_.active_size_ratio >= 0.5;
   const bool memtable_pressure_now =
       slow_flush || imm_pressure || high_active_ratio;
-  constexpr double kL0PressureThreshold = 1.0;
+  // serving wants a shallower L0 than ingest
+  const double l0_pressure_threshold =
+      PhaseBoundsFor(workload_phase_).l0_pressure_threshold;
   constexpr double kPendingPressureThreshold = 1.0;
-  const bool l0_pressure = current_score_.l0_num >= kL0PressureThreshold;
+  const bool l0_pressure = current_score_.l0_num >= l0_pressure_threshold;
   const bool pending_pressure =
       current_score_.estimate_compaction_bytes >= kPendingPressureThreshold;
   const bool compaction_pressure_now = pending_pressure || l0_pressure;
@@ -559,10 +1048,171 @@ TuningOP FEAT_Tuner::TuneByArk() {
     sstable_op = kHalf;
   }
 
+  // The same rules decide memtable and SST sizes of every column family from
+  // its own scores, so a hot column family grows while idle ones do not. A
+  // slow flush only counts for the column families that flushed this round.
+  for (auto &entry : cf_states_) {
+    auto &cf = entry.second;
+    const bool cf_memtable_pressure = (slow_flush && cf.flush_numbers > 0) ||
+                                      cf.immutable_number >= 1 ||
+                                      cf.active_size_ratio >= 0.5;
+    const bool cf_compaction_pressure =
+        cf.estimate_compaction_bytes >= kPendingPressureThreshold ||
+        cf.l0_num >= l0_pressure_threshold;
+    const bool cf_severe_compaction =
+        cf.estimate_compaction_bytes >= 1.5 || cf.l0_num >= 1.2;
+    cf.compaction_pressure_score = accumulate(
+        cf.compaction_pressure_score, cf_compaction_pressure, kMaxScore);
+    if (cf_compaction_pressure) {
+      cf.compaction_relax_counter = 0;
+    } else if (cf.compaction_relax_counter < kRelaxRounds) {
+      cf.compaction_relax_counter++;
+    }
+    cf.memtable_pressure = cf_memtable_pressure;
+
+    cf.batch_op = kKeep;
+    if (cf_memtable_pressure) {
+      cf.batch_op = kLinearIncrease;
+    } else if (cf_compaction_pressure) {
+      cf.batch_op = kHalf;
+    }
+    cf.sstable_op = kKeep;
+    if (cf.compaction_pressure_score >= (cf_severe_compaction ? 1 : 2)) {
+      cf.sstable_op = kLinearIncrease;
+    } else if (cf.compaction_relax_counter >= kRelaxRounds &&
+               !cf_memtable_pressure) {
+      cf.sstable_op = kHalf;
+    }
+
+    if (cf_memtable_pressure) {
+      cf.memtable_relax_counter = 0;
+    } else if (cf.memtable_relax_counter < kRelaxRounds) {
+      cf.memtable_relax_counter++;
+    }
+    SlotOps(cf.immutable_number >= 1, cf.l0_num >= l0_pressure_threshold,
+            cf.memtable_relax_counter >= kRelaxRounds,
+            &cf.write_buffer_number_op, &cf.merge_width_op);
+  }
+
+  // The write stall limits: writes stalled on a column family sitting at
+  // its limits while its L0 and pending bytes did not grow since the last
+  // round are throttled although the compactions keep up, so its limits are
+  // raised. L0 growing beyond the configured slowdown trigger round after
+  // round costs every read another file, so the limits are restored.
+  OpType stall_limit_op = kKeep;
+  for (auto &entry : cf_states_) {
+    auto &cf = entry.second;
+    cf.stall_limit_op = kKeep;
+    if (cf.base_level0_slowdown_writes_trigger <= 0) {
+      continue;
+    }
+    const double factor =
+        std::max(1.0, (double)cf.level0_slowdown_writes_trigger /
+                          cf.base_level0_slowdown_writes_trigger);
+    const bool at_limit = cf.l0_num >= 0.9 * factor ||
+                          cf.estimate_compaction_bytes >= 0.9 * factor;
+    const bool keeping_up =
+        cf.l0_num <= cf.prev_l0_num &&
+        cf.estimate_compaction_bytes <= cf.prev_estimate_compaction_bytes;
+    if (cf.l0_num > cf.prev_l0_num && cf.l0_num >= 1.0) {
+      cf.l0_growth_rounds++;
+    } else {
+      cf.l0_growth_rounds = 0;
+    }
+    if (current_score_.stall_ratio > 0 && at_limit && keeping_up) {
+      cf.stall_limit_op = kLinearIncrease;
+      stall_limit_op = kLinearIncrease;
+    } else if (factor > 1.0 && cf.l0_growth_rounds >= kRelaxRounds) {
+      cf.stall_limit_op = kHalf;
+      if (stall_limit_op == kKeep) {
+        stall_limit_op = kHalf;
+      }
+    }
+    cf.prev_l0_num = cf.l0_num;
+    cf.prev_estimate_compaction_bytes = cf.estimate_compaction_bytes;
+  }
+
+  // The compactions into the levels below the base level leave background
+  // slots to the L0->base level ones while L0 backs up, and queue less I/O
+  // on a congested device. Once the compactions relaxed the caps are lifted.
+  const bool congested =
+      current_score_.io_utilization >= bandwidth_congestion_threshold;
+  OpType deep_compaction_op = kKeep;
+  for (auto &entry : cf_states_) {
+    auto &cf = entry.second;
+    cf.deep_compaction_op = kKeep;
+    if (cf.num_levels - 1 <= cf.base_level) {
+      continue;
+    }
+    if (cf.l0_num >= l0_pressure_threshold || congested) {
+      cf.deep_compaction_op = kHalf;
+      deep_compaction_op = kHalf;
+    } else if (DeepCompactionLimit(cf) > 0 &&
+               cf.compaction_relax_counter >= kRelaxRounds) {
+      cf.deep_compaction_op = kLinearIncrease;
+      if (deep_compaction_op == kKeep) {
+        deep_compaction_op = kLinearIncrease;
+      }
+    }
+  }
+
+  OpType write_buffer_number_op = kKeep;
+  OpType merge_width_op = kKeep;
+  SlotOps(imm_pressure, l0_pressure, memtable_relax_counter_ >= kRelaxRounds,
+          &write_buffer_number_op, &merge_width_op);
+
+  // The RateLimiter budget: an L0 backlog gets the compactions more
+  // bandwidth, a foreground peak gets it back.
+  constexpr double kForegroundPeak = 1.2;
+  const bool foreground_peak =
+      avg_scores.interval_qps > 0 &&
+      current_score_.interval_qps > avg_scores.interval_qps * kForegroundPeak;
+  OpType rate_limit_op = kKeep;
+  if (l0_pressure || severe_compaction) {
+    rate_limit_op = kLinearIncrease;
+  } else if (foreground_peak) {
+    rate_limit_op = kHalf;
+  }
+
+  // Under the latency objective a tail well above its recent average is
+  // pressure of its own. Writes that wait for memtables get more flush
+  // threads, otherwise the background I/O competing with the foreground is
+  // backed off, unless the compactions are behind. Reads slowed down by many
+  // L0 files need the compactions.
+  if (objective_ == TuningObjective::kLatency) {
+    constexpr double kTailSpike = 1.5;
+    const bool write_tail =
+        avg_scores.write_latency_p99 > 0 &&
+        current_score_.write_latency_p99 >
+            avg_scores.write_latency_p99 * kTailSpike;
+    const bool read_tail = avg_scores.read_latency_p99 > 0 &&
+                           current_score_.read_latency_p99 >
+                               avg_scores.read_latency_p99 * kTailSpike;
+    if (write_tail && (imm_pressure || current_score_.stall_ratio > 0)) {
+      flush_op = kLinearIncrease;
+    } else if ((write_tail || read_tail) && !compaction_pressure_now) {
+      compaction_op = kHalf;
+    }
+    if (read_tail && l0_pressure) {
+      compaction_op = kLinearIncrease;
+    }
+    if ((write_tail || read_tail) && !l0_pressure) {
+      rate_limit_op = kHalf;
+    }
+  }
+
   result.FlushThreadOp = flush_op;
   result.CompactionThreadOp = compaction_op;
   result.BatchOp = batch_op;
   result.SSTableOp = sstable_op;
+  result.RateLimitOp = rate_limit_op;
+  result.WriteBufferNumberOp = write_buffer_number_op;
+  result.MergeWidthOp = merge_width_op;
+  result.StallLimitOp = stall_limit_op;
+  result.DeepCompactionOp = deep_compaction_op;
+  if (replay_input_ != nullptr) {
+    return result;
+  }
   std::cout << "[ARK] flush_avg=" << current_score_.flush_speed_avg
             << " baseline=" << flush_baseline
             << " imm=" << current_score_.immutable_number
@@ -573,27 +1223,270 @@ TuningOP FEAT_Tuner::TuneByArk() {
             << " stall_cnt=" << stall_suspect_counter_
             << " flush_idle=" << current_score_.flush_idle_time
             << " comp_idle=" << current_score_.compaction_idle_time
-            << " ops(flush/comp/batch/sstable)="
+            << " apply_us=" << last_apply_micros_
+            << " write_p99=" << current_score_.write_latency_p99
+            << " read_p99=" << current_score_.read_latency_p99
+            << " io_util=" << current_score_.io_utilization
+            << " phase=" << TuningWorkload::PhaseName(workload_phase_)
+            << " ops(flush/comp/batch/sstable/rate_limit/slots/merge/"
+               "stall_limit/deep_compaction)="
             << OpString(result.FlushThreadOp) << "/"
             << OpString(result.CompactionThreadOp) << "/"
             << OpString(result.BatchOp) << "/"
-            << OpString(result.SSTableOp) << std::endl;
+            << OpString(result.SSTableOp) << "/"
+            << OpString(result.RateLimitOp) << "/"
+            << OpString(result.WriteBufferNumberOp) << "/"
+            << OpString(result.MergeWidthOp) << "/"
+            << OpString(result.StallLimitOp) << "/"
+            << OpString(result.DeepCompactionOp) << std::endl;
 
   return result;
 }
 
 
 
+namespace {
+std::string KnobName(const std::string &opt, bool db_width, uint32_t cf_id) {
+  return db_width ? opt : opt + "@" + std::to_string(cf_id);
+}
+
+ChangePoint MakeChangePoint(const std::string &opt, uint64_t value,
+                            bool db_width, uint32_t cf_id = 0) {
+  ChangePoint point;
+  point.opt = opt;
+  point.value = std::to_string(value);
+  point.db_width = db_width;
+  point.cf_id = cf_id;
+  return point;
+}
+
+ChangePoint MakeChangePoint(const std::string &opt, const std::string &value,
+                            bool db_width, uint32_t cf_id = 0) {
+  ChangePoint point;
+  point.opt = opt;
+  point.value = value;
+  point.db_width = db_width;
+  point.cf_id = cf_id;
+  return point;
+}
+
+// max_compactions_per_output_level as SetOptions() takes it
+std::string OutputLevelLimitsString(const std::vector<int> &limits) {
+  if (limits.empty()) {
+    return "0";
+  }
+  std::string value;
+  for (size_t i = 0; i < limits.size(); i++) {
+    value += (i > 0 ? ":" : "") + std::to_string(limits[i]);
+  }
+  return value;
+}
+
+// the ARK history of `from`, but none of its options or scores
+void CopyArkHistory(const ColumnFamilyTuningState &from,
+                    ColumnFamilyTuningState *to) {
+  to->compaction_pressure_score = from.compaction_pressure_score;
+  to->compaction_relax_counter = from.compaction_relax_counter;
+  to->memtable_relax_counter = from.memtable_relax_counter;
+  to->memtable_pressure = from.memtable_pressure;
+  to->batch_op = from.batch_op;
+  to->sstable_op = from.sstable_op;
+  to->write_buffer_number_op = from.write_buffer_number_op;
+  to->merge_width_op = from.merge_width_op;
+  to->prev_l0_num = from.prev_l0_num;
+  to->prev_estimate_compaction_bytes = from.prev_estimate_compaction_bytes;
+  to->l0_growth_rounds = from.l0_growth_rounds;
+  to->stall_limit_op = from.stall_limit_op;
+  to->deep_compaction_op = from.deep_compaction_op;
+}
+}  // namespace
+
+void DOTA_Tuner::SetColumnFamilySizes(std::vector<ChangePoint> *change_list,
+                                      std::vector<ChangePoint> *undo,
+                                      const ColumnFamilyTuningState &cf,
+                                      uint64_t memtable_target,
+                                      uint64_t sstable_target,
+                                      int merge_target) {
+  std::vector<ChangePoint> restore;
+  if (memtable_target != cf.write_buffer_size) {
+    change_list->push_back(
+        MakeChangePoint(memtable_size, memtable_target, false, cf.id));
+    restore.push_back(
+        MakeChangePoint(memtable_size, cf.write_buffer_size, false, cf.id));
+  }
+  if (memtable_target != cf.write_buffer_size ||
+      merge_target != cf.min_write_buffer_number_to_merge) {
+    const uint64_t l0_trigger = cf.level0_file_num_compaction_trigger;
+    change_list->push_back(MakeChangePoint(
+        total_l1_size, l0_trigger * merge_target * memtable_target, false,
+        cf.id));
+    restore.push_back(MakeChangePoint(
+        total_l1_size,
+        l0_trigger * cf.min_write_buffer_number_to_merge *
+            cf.write_buffer_size,
+        false, cf.id));
+  }
+  if (sstable_target != cf.target_file_size_base) {
+    change_list->push_back(
+        MakeChangePoint(sst_size, sstable_target, false, cf.id));
+    restore.push_back(
+        MakeChangePoint(sst_size, cf.target_file_size_base, false, cf.id));
+  }
+  if (undo != nullptr) {
+    undo->insert(undo->end(), restore.begin(), restore.end());
+  }
+}
+
+bool DOTA_Tuner::JudgeLastChange(std::vector<ChangePoint> *change_list) {
+  if (!pending_change_.active || scores.empty()) {
+    return false;
+  }
+  pending_change_.qps_after += scores.back().interval_qps;
+  pending_change_.stall_after += scores.back().stall_ratio;
+  pending_change_.write_p99_after += scores.back().write_latency_p99;
+  pending_change_.read_p99_after += scores.back().read_latency_p99;
+  if (++pending_change_.rounds < feedback_rounds) {
+    return true;
+  }
+  pending_change_.active = false;
+  const double qps_after = pending_change_.qps_after / pending_change_.rounds;
+  const double stall_after =
+      pending_change_.stall_after / pending_change_.rounds;
+  const bool more_stalls =
+      stall_after > pending_change_.stall_before + stall_tolerance;
+  bool worse = false;
+  if (objective_ == TuningObjective::kLatency) {
+    auto longer_tail = [&](double before, double after_sum) {
+      return before > 0 &&
+             after_sum / pending_change_.rounds >
+                 before * (1 + latency_tolerance);
+    };
+    worse = longer_tail(pending_change_.write_p99_before,
+                        pending_change_.write_p99_after) ||
+            longer_tail(pending_change_.read_p99_before,
+                        pending_change_.read_p99_after);
+  } else {
+    worse = pending_change_.qps_before > 0 &&
+            qps_after < pending_change_.qps_before * (1 - qps_tolerance);
+  }
+  if (!worse && !more_stalls) {
+    return false;
+  }
+
+  for (const auto &point : pending_change_.undo) {
+    auto &history =
+        knob_history_[KnobName(point.opt, point.db_width, point.cf_id)];
+    history.direction = 0;
+    history.reversals = 0;
+    history.cool_down_until = ark_rounds_ + cool_down_rounds;
+    change_list->push_back(point);
+  }
+  current_flush_threads_ = pending_change_.flush_threads;
+  current_compaction_threads_ = pending_change_.compaction_threads;
+  rate_limit_ = pending_change_.rate_limit;
+  rolled_back_changes_++;
+  if (replay_input_ == nullptr) {
+    std::cout << "[ARK] roll back, qps " << pending_change_.qps_before
+              << " -> " << qps_after << ", stall "
+              << pending_change_.stall_before << " -> " << stall_after
+              << ", write p99 " << pending_change_.write_p99_before << " -> "
+              << pending_change_.write_p99_after / pending_change_.rounds
+              << std::endl;
+  }
+  return true;
+}
+
+bool DOTA_Tuner::AllowKnobChange(const std::string &knob, uint64_t from,
+                                 uint64_t to) {
+  if (!KnobMayChange(knob, from, to)) {
+    return false;
+  }
+  RecordKnobChange(knob, from, to);
+  return true;
+}
+
+bool DOTA_Tuner::KnobMayChange(const std::string &knob, uint64_t from,
+                               uint64_t to) {
+  if (from == to) {
+    return true;
+  }
+  auto &history = knob_history_[knob];
+  if (ark_rounds_ < history.cool_down_until) {
+    return false;
+  }
+  if (history.changed &&
+      ark_rounds_ - history.changed_round < min_dwell_rounds) {
+    return false;
+  }
+  const uint64_t step = to > from ? to - from : from - to;
+  if (static_cast<double>(step) < hysteresis_band * from) {
+    return false;
+  }
+  const int direction = to > from ? 1 : -1;
+  const bool reversal = history.direction == -direction &&
+                        ark_rounds_ - history.changed_round <= ping_pong_rounds;
+  if (reversal && history.reversals + 1 >= 2) {
+    // ping-pong, e.g. a memtable going back and forth between two sizes
+    history.direction = 0;
+    history.reversals = 0;
+    history.cool_down_until = ark_rounds_ + cool_down_rounds;
+    return false;
+  }
+  return true;
+}
+
+void DOTA_Tuner::RecordKnobChange(const std::string &knob, uint64_t from,
+                                  uint64_t to) {
+  if (from == to) {
+    return;
+  }
+  auto &history = knob_history_[knob];
+  const int direction = to > from ? 1 : -1;
+  const bool reversal = history.direction == -direction &&
+                        ark_rounds_ - history.changed_round <= ping_pong_rounds;
+  history.reversals = reversal ? history.reversals + 1 : 0;
+  history.changed = true;
+  history.direction = direction;
+  history.changed_round = ark_rounds_;
+}
+
+void DOTA_Tuner::ExpectFeedback(std::vector<ChangePoint> &&undo,
+                                int flush_threads, int compaction_threads,
+                                uint64_t rate_limit) {
+  // the window before the change, this round included
+  SystemScores before;
+  int window = 0;
+  for (auto it = scores.rbegin();
+       it != scores.rend() && window < feedback_rounds; ++it, ++window) {
+    before = before + *it;
+  }
+  if (window > 0) {
+    before = before / window;
+  }
+  pending_change_ = PendingChange();
+  pending_change_.active = true;
+  pending_change_.qps_before = before.interval_qps;
+  pending_change_.stall_before = before.stall_ratio;
+  pending_change_.write_p99_before = before.write_latency_p99;
+  pending_change_.read_p99_before = before.read_latency_p99;
+  pending_change_.undo = std::move(undo);
+  pending_change_.flush_threads = flush_threads;
+  pending_change_.compaction_threads = compaction_threads;
+  pending_change_.rate_limit = rate_limit;
+}
+
 void DOTA_Tuner::FillUpChangeListArk(std::vector<ChangePoint> *change_list,
                                      TuningOP op) {
-  uint64_t memtable_target = current_opt.write_buffer_size;
-  uint64_t sstable_target = current_opt.target_file_size_base;
-  const uint64_t original_memtable = memtable_target;
-  const uint64_t original_sstable = sstable_target;
+  if (trace_record_ != nullptr) {
+    trace_record_->decided = true;
+    trace_record_->op = op;
+  }
+  ark_rounds_++;
+  if (JudgeLastChange(change_list)) {
+    return;
+  }
   const int original_flush_threads = current_flush_threads_;
   const int original_compaction_threads = current_compaction_threads_;
-  bool memtable_changed = false;
-  bool sstable_changed = false;
   bool flush_changed = false;
   bool compaction_changed = false;
 
@@ -604,54 +1497,146 @@ void DOTA_Tuner::FillUpChangeListArk(std::vector<ChangePoint> *change_list,
   if (db_thread_cap > max_thread) {
     max_thread = db_thread_cap;
   }
+  // A new workload phase brings every size and the compaction threads into
+  // its bounds, even those the ops keep.
+  const PhaseBounds bounds = PhaseBoundsFor(workload_phase_);
+  const bool phase_changed = workload_phase_ != ark_phase_;
+  ark_phase_ = workload_phase_;
 
 
 
   // 与 old 版本不同：memtable 和 SSTable 大小 now 独立调节。以前两者强制相等，
   // 现在可以在 MT stall 时保持小 SST，而在 PS stall 时按需放大。
-  switch (op.BatchOp) {
-    case kLinearIncrease:
-      memtable_target += default_opts.write_buffer_size;
-      memtable_changed = true;
-      break;
-    case kHalf:
-    //11-22
-      memtable_target /= 2;
-      // memtable_target -= default_opts.write_buffer_size;
-      memtable_changed = true;
-      break;
-    case kKeep:
-      break;
-  }
-  
-
-  switch (op.SSTableOp) {
-    case kLinearIncrease: {
-      sstable_target +=  default_opts.target_file_size_base;
-      sstable_changed = true;
-      break;
-    }
-    case kHalf:
-      sstable_target /= 2;
-      // sstable_target -=  default_opts.target_file_size_base;
-      sstable_changed = true;
-      break;
-    case kKeep:
-      break;
-  }
-
+  // Sizes are per column family (ops decided by TuneByArk), the memtables
+  // of all column families share MemtableBudget().
   auto clamp_size = [](uint64_t value, uint64_t lower, uint64_t upper) {
     return std::min(std::max(value, lower), upper);
   };
-  memtable_target =
-      clamp_size(memtable_target, min_memtable_size, max_memtable_size);
-  sstable_target =
-      clamp_size(sstable_target, min_sstable_size, max_sstable_size);
-  if (memtable_changed && memtable_target == original_memtable) {
-    memtable_changed = false;
+  std::map<uint32_t, uint64_t> memtable_targets;
+  std::map<uint32_t, uint64_t> sstable_targets;
+  std::map<uint32_t, int> slot_targets;
+  std::map<uint32_t, int> merge_targets;
+  const int min_memtable_number =
+      std::max(2, default_opts.max_write_buffer_number);
+  const int max_memtable_number_now =
+      std::max(max_memtable_number, min_memtable_number);
+  for (const auto &entry : cf_states_) {
+    const auto &cf = entry.second;
+    int slot_target = cf.max_write_buffer_number;
+    switch (cf.write_buffer_number_op) {
+      case kLinearIncrease:
+        slot_target += 1;
+        break;
+      case kHalf:
+        slot_target /= 2;
+        break;
+      case kKeep:
+        break;
+    }
+    slot_targets[cf.id] =
+        cf.write_buffer_number_op == kKeep
+            ? slot_target
+            : std::min(std::max(slot_target, min_memtable_number),
+                       max_memtable_number_now);
+    // a new slot is tried before a larger memtable
+    const bool slot_first = slot_targets[cf.id] > cf.max_write_buffer_number;
+    bool memtable_tuned = cf.batch_op != kKeep;
+    uint64_t memtable_target = cf.write_buffer_size;
+    switch (cf.batch_op) {
+      case kLinearIncrease:
+        if (!slot_first) {
+          memtable_target += default_opts.write_buffer_size;
+        } else {
+          memtable_tuned = false;
+        }
+        break;
+      case kHalf:
+        //11-22
+        memtable_target /= 2;
+        break;
+      case kKeep:
+        break;
+    }
+    uint64_t sstable_target = cf.target_file_size_base;
+    switch (cf.sstable_op) {
+      case kLinearIncrease:
+        sstable_target += default_opts.target_file_size_base;
+        break;
+      case kHalf:
+        sstable_target /= 2;
+        break;
+      case kKeep:
+        break;
+    }
+    memtable_targets[cf.id] =
+        !memtable_tuned && !phase_changed
+            ? memtable_target
+            : clamp_size(memtable_target, bounds.min_memtable_size,
+                         bounds.max_memtable_size);
+    sstable_targets[cf.id] =
+        cf.sstable_op == kKeep && !phase_changed
+            ? sstable_target
+            : clamp_size(sstable_target, bounds.min_sstable_size,
+                         max_sstable_size);
   }
-  if (sstable_changed && sstable_target == original_sstable) {
-    sstable_changed = false;
+  // The memory budget outranks the dwell: a shrink it forces is emitted
+  // however recently the memtables changed, so the memtable sizes and slots
+  // are only recorded once they fit.
+  for (const auto &entry : cf_states_) {
+    const auto &cf = entry.second;
+    if (!KnobMayChange(KnobName(memtable_size, false, cf.id),
+                       cf.write_buffer_size, memtable_targets[cf.id])) {
+      memtable_targets[cf.id] = cf.write_buffer_size;
+    }
+    if (!AllowKnobChange(KnobName(sst_size, false, cf.id),
+                         cf.target_file_size_base, sstable_targets[cf.id])) {
+      sstable_targets[cf.id] = cf.target_file_size_base;
+    }
+    if (!KnobMayChange(KnobName(memtable_number, false, cf.id),
+                       cf.max_write_buffer_number, slot_targets[cf.id])) {
+      slot_targets[cf.id] = cf.max_write_buffer_number;
+    }
+  }
+  ShareMemtableBudget(&memtable_targets, &slot_targets);
+  for (const auto &entry : cf_states_) {
+    const auto &cf = entry.second;
+    RecordKnobChange(KnobName(memtable_size, false, cf.id),
+                     cf.write_buffer_size, memtable_targets[cf.id]);
+    RecordKnobChange(KnobName(memtable_number, false, cf.id),
+                     cf.max_write_buffer_number, slot_targets[cf.id]);
+  }
+  // At least one memtable is left for the writes while the others flush.
+  for (const auto &entry : cf_states_) {
+    const auto &cf = entry.second;
+    int merge_target = cf.min_write_buffer_number_to_merge;
+    switch (cf.merge_width_op) {
+      case kLinearIncrease:
+        merge_target += 1;
+        break;
+      case kHalf:
+        merge_target /= 2;
+        break;
+      case kKeep:
+        break;
+    }
+    merge_target =
+        std::min(std::max(merge_target, 1), slot_targets[cf.id] - 1);
+    if (!AllowKnobChange(KnobName(merge_width, false, cf.id),
+                         cf.min_write_buffer_number_to_merge, merge_target)) {
+      merge_target = std::min(cf.min_write_buffer_number_to_merge,
+                              slot_targets[cf.id] - 1);
+    }
+    merge_targets[cf.id] = std::max(merge_target, 1);
+  }
+  std::vector<const ColumnFamilyTuningState *> resized_cfs;
+  for (const auto &entry : cf_states_) {
+    const auto &cf = entry.second;
+    if (memtable_targets[cf.id] != cf.write_buffer_size ||
+        sstable_targets[cf.id] != cf.target_file_size_base ||
+        slot_targets[cf.id] != cf.max_write_buffer_number ||
+        merge_targets[cf.id] != cf.min_write_buffer_number_to_merge) {
+      resized_cfs.push_back(&cf);
+    }
   }
 
   OpType flush_op = op.FlushThreadOp;
@@ -720,6 +1705,30 @@ void DOTA_Tuner::FillUpChangeListArk(std::vector<ChangePoint> *change_list,
   // int compaction_min = flush_target_fixed ? 1 : min_thread;
   new_compaction_threads = std::max(1, new_compaction_threads);
   new_compaction_threads = std::min(new_compaction_threads, max_thread);
+  if (compaction_changed || phase_changed) {
+    new_compaction_threads =
+        std::min(std::max(new_compaction_threads, bounds.min_compaction_threads),
+                 bounds.max_compaction_threads);
+    compaction_changed = true;
+  }
+
+  // On a saturated device more threads only queue I/O. The threads may move
+  // between flushes and compactions, flushes first, but not grow in total.
+  const bool io_saturated =
+      !scores.empty() &&
+      scores.back().io_utilization >= bandwidth_congestion_threshold;
+  if (io_saturated) {
+    const int original_total =
+        original_flush_threads + original_compaction_threads;
+    while (new_flush_threads + new_compaction_threads > original_total &&
+           new_compaction_threads > original_compaction_threads) {
+      new_compaction_threads--;
+    }
+    while (new_flush_threads + new_compaction_threads > original_total &&
+           new_flush_threads > original_flush_threads) {
+      new_flush_threads--;
+    }
+  }
 
   // Expand total cap if needed (but not beyond core_num).
   int target_total = new_flush_threads + new_compaction_threads;
@@ -767,9 +1776,140 @@ void DOTA_Tuner::FillUpChangeListArk(std::vector<ChangePoint> *change_list,
       new_compaction_threads == original_compaction_threads) {
     compaction_changed = false;
   }
+  if (flush_changed &&
+      !AllowKnobChange(max_flush_threads_opt, original_flush_threads,
+                       new_flush_threads)) {
+    new_flush_threads = original_flush_threads;
+    flush_changed = false;
+  }
+  if (compaction_changed &&
+      !AllowKnobChange(max_compaction_threads_opt,
+                       original_compaction_threads, new_compaction_threads)) {
+    new_compaction_threads = original_compaction_threads;
+    compaction_changed = false;
+  }
+
+  // The RateLimiter budget stays between a quarter and four times the
+  // configured one, and does not grow on a saturated device either.
+  const uint64_t original_rate_limit = rate_limit_;
+  uint64_t new_rate_limit = rate_limit_;
+  if (rate_limit_ > 0) {
+    const uint64_t min_rate_limit =
+        std::max<uint64_t>(default_rate_limit_ / 4, 1);
+    const uint64_t max_rate_limit =
+        default_rate_limit_ > std::numeric_limits<uint64_t>::max() / 4
+            ? default_rate_limit_
+            : default_rate_limit_ * 4;
+    switch (op.RateLimitOp) {
+      case kLinearIncrease:
+        if (!io_saturated) {
+          new_rate_limit += min_rate_limit;
+        }
+        break;
+      case kHalf:
+        new_rate_limit /= 2;
+        break;
+      case kKeep:
+        break;
+    }
+    if (op.RateLimitOp != kKeep) {
+      new_rate_limit =
+          clamp_size(new_rate_limit, min_rate_limit, max_rate_limit);
+    }
+    if (!AllowKnobChange(rate_limit_opt, rate_limit_, new_rate_limit)) {
+      new_rate_limit = rate_limit_;
+    }
+  }
+  const bool rate_limit_changed = new_rate_limit != original_rate_limit;
+
+  // The write stall limits move together, in whole multiples of the
+  // configured ones, so the stop trigger stays above the slowdown one. A
+  // disabled pending bytes limit stays disabled. The limits in use need not
+  // be a whole multiple, e.g. after SetOptions(), so the factor in use is
+  // not truncated: a raise goes to the next whole multiple above it.
+  std::map<uint32_t, int> stall_factors;
+  std::vector<const ColumnFamilyTuningState *> relimited_cfs;
+  const int max_stall_factor = std::max(1, max_stall_limit_ratio);
+  for (const auto &entry : cf_states_) {
+    const auto &cf = entry.second;
+    if (cf.base_level0_slowdown_writes_trigger <= 0) {
+      continue;
+    }
+    const double factor =
+        std::max(1.0, static_cast<double>(cf.level0_slowdown_writes_trigger) /
+                          cf.base_level0_slowdown_writes_trigger);
+    int new_factor = 0;
+    switch (cf.stall_limit_op) {
+      case kLinearIncrease:
+        if (!io_saturated && factor < max_stall_factor) {
+          new_factor =
+              std::min(static_cast<int>(factor) + 1, max_stall_factor);
+        }
+        break;
+      case kHalf:
+        new_factor = 1;
+        break;
+      case kKeep:
+        break;
+    }
+    if (new_factor == 0) {
+      continue;
+    }
+    const uint64_t slowdown_target =
+        static_cast<uint64_t>(cf.base_level0_slowdown_writes_trigger) *
+        new_factor;
+    const uint64_t slowdown_now =
+        static_cast<uint64_t>(cf.level0_slowdown_writes_trigger);
+    if (slowdown_target == slowdown_now ||
+        !AllowKnobChange(KnobName(l0_slowdown_opt, false, cf.id),
+                         slowdown_now, slowdown_target)) {
+      continue;
+    }
+    stall_factors[cf.id] = new_factor;
+    relimited_cfs.push_back(&cf);
+  }
+
+  // Under L0 pressure the levels below the base level share all but one
+  // compaction thread, on a congested device they get one each. A lifted cap
+  // grows by one, until it no longer limits the compaction threads.
+  std::map<uint32_t, int> deep_limits;
+  std::vector<const ColumnFamilyTuningState *> recapped_cfs;
+  const int compaction_threads = std::max(new_compaction_threads, 1);
+  auto effective_limit = [&](int limit) {
+    return static_cast<uint64_t>(limit > 0 ? limit : compaction_threads);
+  };
+  for (const auto &entry : cf_states_) {
+    const auto &cf = entry.second;
+    const int deep_levels = cf.num_levels - 1 - cf.base_level;
+    if (deep_levels <= 0) {
+      continue;
+    }
+    const int limit = DeepCompactionLimit(cf);
+    int new_limit = limit;
+    switch (cf.deep_compaction_op) {
+      case kHalf:
+        new_limit = io_saturated
+                        ? 1
+                        : std::max(1, (compaction_threads - 1) / deep_levels);
+        break;
+      case kLinearIncrease:
+        new_limit = limit + 1 >= compaction_threads ? 0 : limit + 1;
+        break;
+      case kKeep:
+        break;
+    }
+    if (!AllowKnobChange(KnobName(output_level_limits_opt, false, cf.id),
+                         effective_limit(limit), effective_limit(new_limit))) {
+      new_limit = limit;
+    }
+    if (new_limit != limit) {
+      deep_limits[cf.id] = new_limit;
+      recapped_cfs.push_back(&cf);
+    }
+  }
 
-  if (!memtable_changed && !sstable_changed && !flush_changed &&
-      !compaction_changed) {
+  if (resized_cfs.empty() && !flush_changed && !compaction_changed &&
+      !rate_limit_changed && relimited_cfs.empty() && recapped_cfs.empty()) {
     return;
   }
 
@@ -778,8 +1918,27 @@ void DOTA_Tuner::FillUpChangeListArk(std::vector<ChangePoint> *change_list,
   // printf("memtable_target to %lu, sstable size to %lu, flush threads to %d, compaction threads to %d\n",
   //        memtable_target, sstable_target, new_flush_threads,
   //        new_compaction_threads);
-  if (memtable_changed || sstable_changed) {
-    SetBatchSize(change_list, memtable_target, sstable_target);
+  // the max_background_jobs cap is not rolled back, it only bounds the split
+  std::vector<ChangePoint> undo;
+  for (const auto *cf : resized_cfs) {
+    // A column family whose slots or merge width changed keeps its sizes,
+    // whatever the bounds of the sizes ARK picks itself.
+    SetColumnFamilySizes(change_list, &undo, *cf, memtable_targets[cf->id],
+                         sstable_targets[cf->id], merge_targets[cf->id]);
+    if (slot_targets[cf->id] != cf->max_write_buffer_number) {
+      change_list->push_back(MakeChangePoint(
+          memtable_number, slot_targets[cf->id], false, cf->id));
+      undo.push_back(MakeChangePoint(memtable_number,
+                                     cf->max_write_buffer_number, false,
+                                     cf->id));
+    }
+    if (merge_targets[cf->id] != cf->min_write_buffer_number_to_merge) {
+      change_list->push_back(MakeChangePoint(
+          merge_width, merge_targets[cf->id], false, cf->id));
+      undo.push_back(MakeChangePoint(merge_width,
+                                     cf->min_write_buffer_number_to_merge,
+                                     false, cf->id));
+    }
   }
 
   // if (flush_changed){
@@ -797,6 +1956,8 @@ void DOTA_Tuner::FillUpChangeListArk(std::vector<ChangePoint> *change_list,
     flush_threads_cp.value = std::to_string(new_flush_threads);
     change_list->push_back(flush_threads_cp);
     current_flush_threads_ = new_flush_threads;
+    undo.push_back(
+        MakeChangePoint(max_flush_threads_opt, original_flush_threads, true));
   }
   // //compaction
   if (compaction_changed){
@@ -806,7 +1967,64 @@ void DOTA_Tuner::FillUpChangeListArk(std::vector<ChangePoint> *change_list,
     comp_threads_cp.value = std::to_string(new_compaction_threads);
     change_list->push_back(comp_threads_cp);
     current_compaction_threads_ = new_compaction_threads;
+    undo.push_back(MakeChangePoint(max_compaction_threads_opt,
+                                   original_compaction_threads, true));
+  }
+  if (rate_limit_changed) {
+    change_list->push_back(
+        MakeChangePoint(rate_limit_opt, new_rate_limit, true));
+    rate_limit_ = new_rate_limit;
+    undo.push_back(MakeChangePoint(rate_limit_opt, original_rate_limit, true));
   }
+  for (const auto *cf : relimited_cfs) {
+    const uint64_t factor = stall_factors[cf->id];
+    change_list->push_back(MakeChangePoint(
+        l0_slowdown_opt, cf->base_level0_slowdown_writes_trigger * factor,
+        false, cf->id));
+    change_list->push_back(MakeChangePoint(
+        l0_stop_opt, cf->base_level0_stop_writes_trigger * factor, false,
+        cf->id));
+    undo.push_back(MakeChangePoint(
+        l0_slowdown_opt, cf->level0_slowdown_writes_trigger, false, cf->id));
+    undo.push_back(MakeChangePoint(l0_stop_opt, cf->level0_stop_writes_trigger,
+                                   false, cf->id));
+    // 0 disables a pending bytes limit
+    if (cf->base_soft_pending_compaction_bytes_limit > 0) {
+      change_list->push_back(MakeChangePoint(
+          soft_pending_opt,
+          cf->base_soft_pending_compaction_bytes_limit * factor, false,
+          cf->id));
+      undo.push_back(MakeChangePoint(soft_pending_opt,
+                                     cf->soft_pending_compaction_bytes_limit,
+                                     false, cf->id));
+    }
+    if (cf->base_hard_pending_compaction_bytes_limit > 0) {
+      change_list->push_back(MakeChangePoint(
+          hard_pending_opt,
+          cf->base_hard_pending_compaction_bytes_limit * factor, false,
+          cf->id));
+      undo.push_back(MakeChangePoint(hard_pending_opt,
+                                     cf->hard_pending_compaction_bytes_limit,
+                                     false, cf->id));
+    }
+  }
+  // the levels down to the base level keep their caps
+  for (const auto *cf : recapped_cfs) {
+    std::vector<int> limits = cf->max_compactions_per_output_level;
+    limits.resize(cf->num_levels, 0);
+    for (int level = cf->base_level + 1; level < cf->num_levels; level++) {
+      limits[level] = deep_limits[cf->id];
+    }
+    change_list->push_back(MakeChangePoint(
+        output_level_limits_opt, OutputLevelLimitsString(limits), false,
+        cf->id));
+    undo.push_back(MakeChangePoint(
+        output_level_limits_opt,
+        OutputLevelLimitsString(cf->max_compactions_per_output_level), false,
+        cf->id));
+  }
+  ExpectFeedback(std::move(undo), original_flush_threads,
+                 original_compaction_threads, original_rate_limit);
 }
 
 
@@ -855,6 +2073,168 @@ TuningOP FEAT_Tuner::TuneByFEA() {
   }
   return negative_protocol;
 }
+Status FEAT_Tuner::ResumeFrom(const std::string &path) {
+  state_file_ = path;
+  auto state = std::make_shared<TunerState>();
+  Status s = ReadTunerState(env_, path, state.get());
+  if (s.IsNotFound() || s.IsPathNotFound()) {
+    return Status::OK();
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  max_scores = state->max_scores;
+  avg_scores = state->avg_scores;
+  // the saved average stands for the rounds before the restart
+  if (state->avg_scores.flush_speed_avg > 0) {
+    scores.push_back(state->avg_scores);
+  }
+  memtable_pressure_score_ = state->counters.memtable_pressure_score;
+  compaction_pressure_score_ = state->counters.compaction_pressure_score;
+  memtable_relax_counter_ = state->counters.memtable_relax_counter;
+  compaction_relax_counter_ = state->counters.compaction_relax_counter;
+  stall_suspect_counter_ = state->counters.stall_suspect_counter;
+  max_thread = std::max(max_thread, state->max_thread);
+  workload_.Resume(state->workload_phase);
+  workload_phase_ = state->workload_phase;
+  ark_phase_ = state->workload_phase;
+  if (running_db_ == nullptr) {
+    // nothing to apply the options to
+    current_flush_threads_ = state->flush_threads;
+    current_compaction_threads_ = state->compaction_threads;
+    rate_limit_ = state->rate_limit;
+    return Status::OK();
+  }
+  resume_state_ = std::move(state);
+  return Status::OK();
+}
+
+Status FEAT_Tuner::SaveState() {
+  if (state_file_.empty()) {
+    return Status::OK();
+  }
+  TunerState state;
+  state.max_scores = max_scores;
+  state.avg_scores = avg_scores;
+  state.counters = GetArkCounters();
+  state.max_thread = max_thread;
+  state.flush_threads = current_flush_threads_;
+  state.compaction_threads = current_compaction_threads_;
+  state.rate_limit = rate_limit_;
+  state.workload_phase = workload_phase_;
+  for (const auto &entry : cf_states_) {
+    state.cf_states.push_back(entry.second);
+  }
+  rounds_since_save_ = 0;
+  return WriteTunerState(env_, state_file_, state);
+}
+
+void FEAT_Tuner::ResumeRound(std::vector<ChangePoint> *change_list) {
+  const TunerState &saved = *resume_state_;
+  std::map<std::string, const ColumnFamilyTuningState *> saved_cfs;
+  for (const auto &cf : saved.cf_states) {
+    saved_cfs[cf.name] = &cf;
+  }
+  // The options, and with them the base stall limits and the block caches
+  // of the budget, are the live ones. Only the ARK history carries over.
+  cf_states_.clear();
+  SystemScores live_score;
+  ScoreColumnFamilies(&live_score);
+  std::map<uint32_t, uint64_t> memtable_targets;
+  std::map<uint32_t, int> slot_targets;
+  for (auto &entry : cf_states_) {
+    auto &cf = entry.second;
+    memtable_targets[cf.id] = cf.write_buffer_size;
+    slot_targets[cf.id] = cf.max_write_buffer_number;
+    auto it = saved_cfs.find(cf.name);
+    if (it != saved_cfs.end()) {
+      CopyArkHistory(*it->second, &cf);
+      memtable_targets[cf.id] = it->second->write_buffer_size;
+      slot_targets[cf.id] = it->second->max_write_buffer_number;
+    }
+  }
+  // the memory budget may be smaller than when the state was saved
+  ShareMemtableBudget(&memtable_targets, &slot_targets);
+  const int max_ratio = std::max(1, max_stall_limit_ratio);
+  for (const auto &entry : cf_states_) {
+    const auto &cf = entry.second;
+    auto it = saved_cfs.find(cf.name);
+    if (it == saved_cfs.end()) {
+      continue;
+    }
+    const ColumnFamilyTuningState &saved_cf = *it->second;
+    const int slots = slot_targets[cf.id];
+    const int merge_target = std::max(
+        1, std::min(saved_cf.min_write_buffer_number_to_merge, slots - 1));
+    SetColumnFamilySizes(change_list, nullptr, cf, memtable_targets[cf.id],
+                         saved_cf.target_file_size_base, merge_target);
+    if (slots != cf.max_write_buffer_number) {
+      change_list->push_back(
+          MakeChangePoint(memtable_number, slots, false, cf.id));
+    }
+    if (merge_target != cf.min_write_buffer_number_to_merge) {
+      change_list->push_back(
+          MakeChangePoint(merge_width, merge_target, false, cf.id));
+    }
+    // ARK raised all four stall limits by one factor over the configured
+    // ones, which may have changed since
+    int factor = 1;
+    if (saved_cf.base_level0_slowdown_writes_trigger > 0) {
+      factor = std::min(
+          max_ratio,
+          std::max(1, saved_cf.level0_slowdown_writes_trigger /
+                          saved_cf.base_level0_slowdown_writes_trigger));
+    }
+    if (factor > 1) {
+      change_list->push_back(MakeChangePoint(
+          l0_slowdown_opt, cf.base_level0_slowdown_writes_trigger * factor,
+          false, cf.id));
+      change_list->push_back(MakeChangePoint(
+          l0_stop_opt, cf.base_level0_stop_writes_trigger * factor, false,
+          cf.id));
+      if (cf.base_soft_pending_compaction_bytes_limit > 0) {
+        change_list->push_back(MakeChangePoint(
+            soft_pending_opt,
+            cf.base_soft_pending_compaction_bytes_limit * factor, false,
+            cf.id));
+      }
+      if (cf.base_hard_pending_compaction_bytes_limit > 0) {
+        change_list->push_back(MakeChangePoint(
+            hard_pending_opt,
+            cf.base_hard_pending_compaction_bytes_limit * factor, false,
+            cf.id));
+      }
+    }
+    if (saved_cf.max_compactions_per_output_level !=
+        cf.max_compactions_per_output_level) {
+      change_list->push_back(MakeChangePoint(
+          output_level_limits_opt,
+          OutputLevelLimitsString(saved_cf.max_compactions_per_output_level),
+          false, cf.id));
+    }
+  }
+  if (saved.flush_threads > 0 &&
+      saved.flush_threads != current_flush_threads_) {
+    current_flush_threads_ = saved.flush_threads;
+    change_list->push_back(
+        MakeChangePoint(max_flush_threads_opt, current_flush_threads_, true));
+  }
+  if (saved.compaction_threads > 0 &&
+      saved.compaction_threads != current_compaction_threads_) {
+    current_compaction_threads_ = saved.compaction_threads;
+    change_list->push_back(MakeChangePoint(
+        max_compaction_threads_opt, current_compaction_threads_, true));
+  }
+  // the RateLimiter is only resumed when the DB has one
+  if (rate_limit_ > 0 && saved.rate_limit > 0 &&
+      saved.rate_limit != rate_limit_) {
+    rate_limit_ = saved.rate_limit;
+    change_list->push_back(MakeChangePoint(rate_limit_opt, rate_limit_, true));
+  }
+  std::cout << "[ARK] resumed from " << state_file_ << ", "
+            << change_list->size() << " changes" << std::endl;
+}
+
 void FEAT_Tuner::CalculateAvgScore() {
   SystemScores result;
   for (auto score : scores) {
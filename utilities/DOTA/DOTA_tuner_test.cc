@@ -0,0 +1,500 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utilities/DOTA/tuner_test_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The decisions of the ARK policy, round by round.
+class DOTATunerTest : public TunerTestBase {};
+
+TEST_F(DOTATunerTest, RollBackRegressions) {
+  auto tuner = NewTuner();
+  // every change halves the throughput
+  double qps = 1000;
+  size_t rollback_round = 0;
+  std::vector<TunerTraceRecord> outputs;
+  for (auto& input : Inputs()) {
+    input.scores.interval_qps = qps;
+    const uint64_t rolled_back = tuner->RolledBackChanges();
+    outputs.emplace_back();
+    tuner->ReplayRound(input, &outputs.back());
+    if (!outputs.back().change_points.empty()) {
+      qps /= 2;
+    }
+    if (rollback_round == 0 && tuner->RolledBackChanges() > rolled_back) {
+      rollback_round = outputs.size() - 1;
+    }
+  }
+  ASSERT_GT(rollback_round, 0U);
+
+  // the rollback restores the compaction threads of the traced rounds and
+  // the knob rests afterwards
+  bool restored = false;
+  for (const auto& point : outputs[rollback_round].change_points) {
+    if (point.opt == "max_background_compactions") {
+      ASSERT_EQ("3", point.value);
+      restored = true;
+    }
+  }
+  ASSERT_TRUE(restored);
+  for (size_t i = rollback_round + 1; i < outputs.size(); i++) {
+    for (const auto& point : outputs[i].change_points) {
+      ASSERT_NE("max_background_compactions", point.opt);
+    }
+  }
+}
+
+TEST_F(DOTATunerTest, WorkloadPhaseBounds) {
+  // the write burst of Inputs() while the DB serves reads: the memtables do
+  // not grow and the compactions keep half of the threads
+  auto inputs = Inputs();
+  for (auto& input : inputs) {
+    input.workload_phase = TuningWorkload::kReadHeavy;
+  }
+  for (const auto& output : Replay(inputs)) {
+    ASSERT_EQ(TuningWorkload::kReadHeavy, output.workload_phase);
+    for (const auto& point : output.change_points) {
+      if (point.opt == "write_buffer_size") {
+        ASSERT_LE(std::stoull(point.value), 64U << 20);
+      } else if (point.opt == "max_background_compactions") {
+        ASSERT_GE(std::stoi(point.value), 2);
+      }
+    }
+  }
+
+  // during ingest the memtables start at twice the default and the
+  // compactions get at most half of the threads
+  inputs = Inputs();
+  for (auto& input : inputs) {
+    input.workload_phase = TuningWorkload::kWriteHeavy;
+  }
+  bool memtables_raised = false;
+  for (const auto& output : Replay(inputs)) {
+    for (const auto& point : output.change_points) {
+      if (point.opt == "write_buffer_size" &&
+          std::stoull(point.value) >= (128U << 20)) {
+        memtables_raised = true;
+      } else if (point.opt == "max_background_compactions") {
+        ASSERT_LE(std::stoi(point.value), 2);
+      }
+    }
+  }
+  ASSERT_TRUE(memtables_raised);
+}
+
+TEST_F(DOTATunerTest, MemtablesStayWithinBudget) {
+  // both memtables of the column family fill the budget already
+  const uint64_t kBudget = 2 * (64U << 20);
+  auto inputs = Inputs();
+  for (auto& input : inputs) {
+    input.memtable_budget = kBudget;
+  }
+  for (const auto& output : Replay(inputs)) {
+    for (const auto& point : output.change_points) {
+      if (point.opt == "write_buffer_size") {
+        ASSERT_LE(std::stoull(point.value) *
+                      inputs[0].cf_states[0].max_write_buffer_number,
+                  kBudget);
+      } else if (point.opt == "max_write_buffer_number") {
+        ASSERT_LE(std::stoi(point.value),
+                  inputs[0].cf_states[0].max_write_buffer_number);
+      }
+    }
+  }
+
+  // without a budget the write burst adds memtables
+  bool grown = false;
+  for (const auto& output : Replay(Inputs())) {
+    for (const auto& point : output.change_points) {
+      grown |= point.opt == "max_write_buffer_number" &&
+               std::stoi(point.value) >
+                   inputs[0].cf_states[0].max_write_buffer_number;
+    }
+  }
+  ASSERT_TRUE(grown);
+}
+
+TEST_F(DOTATunerTest, SlotsAndMergeWidth) {
+  auto inputs = Inputs();
+  for (auto& input : inputs) {
+    input.cf_states[0].max_write_buffer_number = 4;
+  }
+  auto outputs = Replay(inputs);
+  bool slot_added = false;
+  bool merged_more = false;
+  for (size_t i = 0; i < outputs.size(); i++) {
+    std::map<std::string, uint64_t> points;
+    for (const auto& point : outputs[i].change_points) {
+      points[point.opt] = std::stoull(point.value);
+    }
+    if (points.count("max_write_buffer_number") &&
+        points["max_write_buffer_number"] > 4) {
+      // the flush backlog gets a slot rather than a larger memtable
+      slot_added = true;
+      ASSERT_GE(inputs[i].cf_states[0].immutable_number, 1);
+      ASSERT_LE(points["write_buffer_size"], 64U << 20);
+    }
+    if (points.count("min_write_buffer_number_to_merge") &&
+        points["min_write_buffer_number_to_merge"] > 1) {
+      // the L0 backlog merges more memtables per flush, the L1 target
+      // follows
+      merged_more = true;
+      const auto& cf = inputs[i].cf_states[0];
+      const uint64_t merge = points["min_write_buffer_number_to_merge"];
+      const uint64_t memtable = points.count("write_buffer_size")
+                                    ? points["write_buffer_size"]
+                                    : cf.write_buffer_size;
+      ASSERT_GE(cf.l0_num, 1.0);
+      ASSERT_LT(merge, 4U);
+      ASSERT_EQ(cf.level0_file_num_compaction_trigger * merge * memtable,
+                points["max_bytes_for_level_base"]);
+    }
+  }
+  ASSERT_TRUE(slot_added);
+  ASSERT_TRUE(merged_more);
+}
+
+TEST_F(DOTATunerTest, NewSlotsKeepSmallMemtables) {
+  // memtables below the sizes ARK picks itself
+  const uint64_t kMemtableSize = 8 << 20;
+  auto inputs = Inputs();
+  for (auto& input : inputs) {
+    input.cf_states[0].write_buffer_size = kMemtableSize;
+    input.cf_states[0].max_write_buffer_number = 4;
+  }
+  bool slot_added = false;
+  for (const auto& output : Replay(inputs)) {
+    bool slots = false;
+    bool resized = false;
+    for (const auto& point : output.change_points) {
+      slots |= point.opt == "max_write_buffer_number";
+      resized |= point.opt == "write_buffer_size";
+    }
+    if (slots) {
+      slot_added = true;
+      ASSERT_FALSE(resized);
+    }
+  }
+  ASSERT_TRUE(slot_added);
+}
+
+TEST_F(DOTATunerTest, RateLimitFollowsPressure) {
+  const uint64_t kRateLimit = 64 << 20;
+  TunerTraceHeader header = Header();
+  header.rate_limit_bytes_per_sec = kRateLimit;
+  auto tuner = NewTuner(header);
+
+  // the L0 backlog of the last rounds of Inputs(), then a foreground peak
+  // without any backlog
+  auto inputs = Inputs();
+  const size_t peak_round = inputs.size();
+  for (int i = 0; i < 6; i++) {
+    TunerTraceRecord input = inputs[0];
+    input.secs_elapsed = static_cast<int>(inputs.size()) + 1;
+    input.scores.interval_qps = 2000;
+    inputs.push_back(input);
+  }
+  uint64_t rate_limit = kRateLimit;
+  uint64_t max_rate_limit = kRateLimit;
+  bool given_back = false;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    auto& input = inputs[i];
+    if (i < peak_round) {
+      input.scores.interval_qps = 1000;
+    }
+    input.rate_limit = rate_limit;
+    TunerTraceRecord output;
+    tuner->ReplayRound(input, &output);
+    for (const auto& point : output.change_points) {
+      if (point.opt != kRateLimiterBytesPerSec) {
+        continue;
+      }
+      ASSERT_TRUE(point.db_width);
+      const uint64_t value = std::stoull(point.value);
+      if (i < peak_round) {
+        // only the backlog raises the budget
+        ASSERT_GT(value, rate_limit);
+        ASSERT_GE(input.scores.l0_num, 1.0);
+      } else if (value < rate_limit) {
+        given_back = true;
+      }
+      ASSERT_LE(value, 4 * kRateLimit);
+      ASSERT_GE(value, kRateLimit / 4);
+      rate_limit = value;
+      max_rate_limit = std::max(max_rate_limit, value);
+    }
+  }
+  ASSERT_GT(max_rate_limit, kRateLimit);
+  ASSERT_TRUE(given_back);
+}
+
+TEST_F(DOTATunerTest, StallLimitsFollowCompaction) {
+  const uint64_t kSlowdown = 20;
+  const uint64_t kStop = 36;
+  const uint64_t kSoft = 64ULL << 30;
+  const uint64_t kHard = 256ULL << 30;
+  auto tuner = NewTuner();
+
+  std::map<std::string, uint64_t> limits = {
+      {"level0_slowdown_writes_trigger", kSlowdown},
+      {"level0_stop_writes_trigger", kStop},
+      {"soft_pending_compaction_bytes_limit", kSoft},
+      {"hard_pending_compaction_bytes_limit", kHard}};
+  uint64_t max_slowdown = kSlowdown;
+  // Writes stall with L0 just below the slowdown trigger in use, which the
+  // compactions hold there. Then L0 keeps growing without any stall.
+  for (int i = 0; i < 40; i++) {
+    TunerTraceRecord input = Inputs()[0];
+    input.secs_elapsed = i + 1;
+    auto& cf = input.cf_states[0];
+    cf.base_level0_slowdown_writes_trigger = static_cast<int>(kSlowdown);
+    cf.base_level0_stop_writes_trigger = static_cast<int>(kStop);
+    cf.base_soft_pending_compaction_bytes_limit = kSoft;
+    cf.base_hard_pending_compaction_bytes_limit = kHard;
+    cf.level0_slowdown_writes_trigger =
+        static_cast<int>(limits["level0_slowdown_writes_trigger"]);
+    cf.level0_stop_writes_trigger =
+        static_cast<int>(limits["level0_stop_writes_trigger"]);
+    cf.soft_pending_compaction_bytes_limit =
+        limits["soft_pending_compaction_bytes_limit"];
+    cf.hard_pending_compaction_bytes_limit =
+        limits["hard_pending_compaction_bytes_limit"];
+    if (i < 30) {
+      input.scores.stall_ratio = 0.1;
+      cf.l0_num = 0.95 * cf.level0_slowdown_writes_trigger /
+                  cf.base_level0_slowdown_writes_trigger;
+    } else {
+      cf.l0_num = 1.0 + 0.3 * (i - 30);
+    }
+    input.scores.l0_num = cf.l0_num;
+    TunerTraceRecord output;
+    tuner->ReplayRound(input, &output);
+    for (const auto& point : output.change_points) {
+      if (limits.count(point.opt)) {
+        ASSERT_FALSE(point.db_width);
+        limits[point.opt] = std::stoull(point.value);
+      }
+    }
+    // the limits move together and stay within the bounds
+    const uint64_t factor =
+        limits["level0_slowdown_writes_trigger"] / kSlowdown;
+    ASSERT_GE(factor, 1U);
+    ASSERT_LE(factor, 4U);
+    ASSERT_EQ(kSlowdown * factor, limits["level0_slowdown_writes_trigger"]);
+    ASSERT_EQ(kStop * factor, limits["level0_stop_writes_trigger"]);
+    ASSERT_EQ(kSoft * factor, limits["soft_pending_compaction_bytes_limit"]);
+    ASSERT_EQ(kHard * factor, limits["hard_pending_compaction_bytes_limit"]);
+    max_slowdown =
+        std::max(max_slowdown, limits["level0_slowdown_writes_trigger"]);
+  }
+  ASSERT_GT(max_slowdown, kSlowdown);
+  // the read amplification restored the configured limits
+  ASSERT_EQ(kSlowdown, limits["level0_slowdown_writes_trigger"]);
+  ASSERT_EQ(kHard, limits["hard_pending_compaction_bytes_limit"]);
+}
+
+TEST_F(DOTATunerTest, StallLimitsWithoutPendingLimits) {
+  const int kSlowdown = 20;
+  const int kStop = 36;
+  auto tuner = NewTuner();
+  tuner->set_max_stall_limit_ratio(2);
+
+  // set off the configured ones, e.g. by SetOptions()
+  int slowdown = 30;
+  int stop = 54;
+  bool raised = false;
+  for (int i = 0; i < 30; i++) {
+    TunerTraceRecord input = Inputs()[0];
+    input.secs_elapsed = i + 1;
+    input.scores.stall_ratio = 0.1;
+    auto& cf = input.cf_states[0];
+    cf.base_level0_slowdown_writes_trigger = kSlowdown;
+    cf.base_level0_stop_writes_trigger = kStop;
+    // 0 disables the pending bytes limits
+    cf.base_soft_pending_compaction_bytes_limit = 0;
+    cf.base_hard_pending_compaction_bytes_limit = 0;
+    cf.soft_pending_compaction_bytes_limit = 0;
+    cf.hard_pending_compaction_bytes_limit = 0;
+    cf.estimate_compaction_bytes = 0;
+    cf.level0_slowdown_writes_trigger = slowdown;
+    cf.level0_stop_writes_trigger = stop;
+    cf.l0_num = 0.95 * slowdown / kSlowdown;
+    input.scores.l0_num = cf.l0_num;
+    TunerTraceRecord output;
+    tuner->ReplayRound(input, &output);
+    for (const auto& point : output.change_points) {
+      ASSERT_NE("soft_pending_compaction_bytes_limit", point.opt);
+      ASSERT_NE("hard_pending_compaction_bytes_limit", point.opt);
+      if (point.opt == "level0_slowdown_writes_trigger") {
+        slowdown = std::stoi(point.value);
+        raised = true;
+      } else if (point.opt == "level0_stop_writes_trigger") {
+        stop = std::stoi(point.value);
+      }
+    }
+    if (raised) {
+      // raised to whole multiples of the configured limits
+      ASSERT_EQ(0, slowdown % kSlowdown);
+      ASSERT_EQ(kStop * (slowdown / kSlowdown), stop);
+      ASSERT_LE(slowdown, 2 * kSlowdown);
+    }
+  }
+  ASSERT_TRUE(raised);
+  ASSERT_GT(slowdown, 30);
+}
+
+TEST_F(DOTATunerTest, DeepCompactionCaps) {
+  auto tuner = NewTuner();
+
+  const int kNumLevels = 7;
+  const int kBaseLevel = 1;
+  std::vector<int> limits;
+  bool capped = false;
+  // an L0 backlog, then compactions that keep up
+  for (int i = 0; i < 30; i++) {
+    TunerTraceRecord input = Inputs()[0];
+    input.secs_elapsed = i + 1;
+    auto& cf = input.cf_states[0];
+    cf.num_levels = kNumLevels;
+    cf.base_level = kBaseLevel;
+    cf.max_compactions_per_output_level = limits;
+    cf.l0_num = i < 10 ? 1.5 : 0.2;
+    input.scores.l0_num = cf.l0_num;
+    TunerTraceRecord output;
+    tuner->ReplayRound(input, &output);
+    for (const auto& point : output.change_points) {
+      if (point.opt != "max_compactions_per_output_level") {
+        continue;
+      }
+      ASSERT_FALSE(point.db_width);
+      limits.clear();
+      std::stringstream ss(point.value);
+      std::string limit;
+      while (std::getline(ss, limit, ':')) {
+        limits.push_back(std::stoi(limit));
+      }
+    }
+    if (limits.empty() || limits.back() == 0) {
+      continue;
+    }
+    // only the levels below the base level are capped
+    ASSERT_EQ(static_cast<size_t>(kNumLevels), limits.size());
+    for (int level = 0; level <= kBaseLevel; level++) {
+      ASSERT_EQ(0, limits[level]);
+    }
+    for (int level = kBaseLevel + 1; level < kNumLevels; level++) {
+      ASSERT_EQ(limits.back(), limits[level]);
+    }
+    if (i < 10) {
+      // five levels share fewer threads, one each
+      capped = true;
+      ASSERT_EQ(1, limits.back());
+    }
+  }
+  ASSERT_TRUE(capped);
+  // lifted once the compactions relaxed
+  ASSERT_TRUE(limits.empty() || limits.back() == 0);
+}
+
+TEST_F(DOTATunerTest, KnobsDwell) {
+  auto tuner = NewTuner();
+  tuner->set_safety_envelope(6, 0.05);
+  // memtable pressure all along, ARK adds slots and grows the memtables
+  // whenever it is free to
+  ColumnFamilyTuningState cf = Inputs()[5].cf_states[0];
+  std::map<std::string, std::vector<int>> changed_rounds;
+  for (int i = 0; i < 40; i++) {
+    TunerTraceRecord input = Inputs()[5];
+    input.secs_elapsed = i + 1;
+    input.cf_states[0] = cf;
+    TunerTraceRecord output;
+    tuner->ReplayRound(input, &output);
+    for (const auto& point : output.change_points) {
+      if (point.opt == "write_buffer_size" &&
+          std::stoull(point.value) != cf.write_buffer_size) {
+        cf.write_buffer_size = std::stoull(point.value);
+      } else if (point.opt == "max_write_buffer_number" &&
+                 std::stoi(point.value) != cf.max_write_buffer_number) {
+        cf.max_write_buffer_number = std::stoi(point.value);
+      } else {
+        continue;
+      }
+      changed_rounds[point.opt].push_back(i);
+    }
+  }
+  ASSERT_FALSE(changed_rounds.empty());
+  size_t changes = 0;
+  for (const auto& entry : changed_rounds) {
+    const auto& rounds = entry.second;
+    changes += rounds.size();
+    for (size_t i = 1; i < rounds.size(); i++) {
+      ASSERT_GE(rounds[i] - rounds[i - 1], 6);
+    }
+  }
+  ASSERT_GE(changes, 2U);
+}
+
+TEST_F(DOTATunerTest, BudgetOutranksDwell) {
+  const int kDwell = 6;
+  auto tuner = NewTuner();
+  tuner->set_safety_envelope(kDwell, 0.05);
+  ColumnFamilyTuningState cf = Inputs()[5].cf_states[0];
+  uint64_t budget = 0;
+  int grown_round = -1;
+  int shrunk_round = -1;
+  for (int i = 0; i < 40; i++) {
+    TunerTraceRecord input = Inputs()[5];
+    input.secs_elapsed = i + 1;
+    input.cf_states[0] = cf;
+    // right after ARK grew the memtables the budget halves them
+    if (grown_round >= 0 && shrunk_round < 0) {
+      budget = cf.write_buffer_size / 2 * cf.max_write_buffer_number;
+    }
+    input.memtable_budget = budget;
+    TunerTraceRecord output;
+    tuner->ReplayRound(input, &output);
+    const uint64_t before = cf.write_buffer_size;
+    for (const auto& point : output.change_points) {
+      if (point.opt == "write_buffer_size") {
+        cf.write_buffer_size = std::stoull(point.value);
+      } else if (point.opt == "max_write_buffer_number") {
+        cf.max_write_buffer_number = std::stoi(point.value);
+      }
+    }
+    if (grown_round < 0) {
+      if (cf.write_buffer_size > before) {
+        grown_round = i;
+      }
+    } else if (shrunk_round < 0) {
+      if (cf.write_buffer_size == before) {
+        continue;
+      }
+      // within the dwell of the growth, the memtables fit again
+      ASSERT_LT(i - grown_round, kDwell);
+      ASSERT_LT(cf.write_buffer_size, before);
+      ASSERT_LE(cf.write_buffer_size * cf.max_write_buffer_number, budget);
+      shrunk_round = i;
+      budget = 0;
+    } else if (cf.write_buffer_size != before) {
+      // the dwell counts from the shrink that was emitted
+      ASSERT_GE(i - shrunk_round, kDwell);
+    }
+  }
+  ASSERT_GE(grown_round, 0);
+  ASSERT_GE(shrunk_round, 0);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,84 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "utilities/DOTA/auto_tuner.h"
+
+#include <algorithm>
+
+#include "logging/logging.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+AutoTuner::AutoTuner(DBImpl* db, std::shared_ptr<TuningPolicy> policy,
+                     uint64_t period_sec, uint64_t gap_sec)
+    : db_(db),
+      period_sec_(std::max<uint64_t>(period_sec, 1)),
+      gap_sec_((std::max(gap_sec, period_sec_) + period_sec_ - 1) /
+               period_sec_ * period_sec_),
+      secs_elapsed_(0),
+      tuning_rounds_(0) {
+  // Nobody counts the operations of the application, the tuner takes the
+  // DB's written keys as its throughput.
+  tuner_.reset(new FEAT_Tuner(db_->GetOptions(), db_, nullptr, nullptr,
+                              db_->GetEnv(), static_cast<int>(gap_sec_),
+                              std::move(policy)));
+  tuner_->ResetTuner();
+  const auto& trace_file = db_->immutable_db_options().tuner_trace_file;
+  if (!trace_file.empty()) {
+    Status s = tuner_->StartTrace(db_->GetEnv(), trace_file);
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(db_->immutable_db_options().info_log,
+                     "Can't trace the tuner to %s: %s", trace_file.c_str(),
+                     s.ToString().c_str());
+    }
+  }
+  const auto& state_file = db_->immutable_db_options().tuner_state_file;
+  if (!state_file.empty()) {
+    Status s = tuner_->ResumeFrom(state_file);
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(db_->immutable_db_options().info_log,
+                     "Can't resume the tuner from %s: %s", state_file.c_str(),
+                     s.ToString().c_str());
+    }
+  }
+  executor_.reset(new TuningExecutor(db_));
+}
+
+AutoTuner::~AutoTuner() {
+  // stop applying before the tuner goes away
+  executor_.reset();
+  tuner_->SaveState().PermitUncheckedError();
+}
+
+void AutoTuner::Tick() {
+  secs_elapsed_ += period_sec_;
+  if (executor_->Busy()) {
+    return;
+  }
+  const auto& trigger = db_->immutable_db_options().tuning_trigger;
+  if (secs_elapsed_ % gap_sec_ == 0) {
+    if (trigger != nullptr) {
+      trigger->MarkRound();
+    }
+  } else if (trigger == nullptr || trigger->Poll() == TuningTrigger::kNoReason) {
+    return;
+  }
+  TEST_SYNC_POINT("AutoTuner::Tick:TuningRound");
+  std::vector<ChangePoint> change_points;
+  tuner_->ReportApplyLatency(executor_->LastApplyMicros());
+  tuner_->DetectTuningOperations(static_cast<int>(secs_elapsed_),
+                                 &change_points);
+  tuning_rounds_.fetch_add(1, std::memory_order_relaxed);
+  if (!change_points.empty()) {
+    executor_->Submit(change_points);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+#endif  // ROCKSDB_LITE
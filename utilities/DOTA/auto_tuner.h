@@ -0,0 +1,52 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#ifndef ROCKSDB_LITE
+
+#include <atomic>
+#include <memory>
+
+#include "rocksdb/utilities/report_agent.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Runs DBOptions::tuning_policy against the DB that owns it, driven by the
+// DB's PeriodicTaskScheduler (PeriodicTaskType::kAutoTune) instead of a
+// reporter agent. Every Tick() advances the tuner's clock by the task period
+// and a tuning round runs once every gap, or on the first tick after the DB's
+// TuningTrigger fired in between. The decided changes are applied by
+// a TuningExecutor, so a slow SetOptions() never holds up the timer thread
+// that is shared by all DB instances.
+class AutoTuner {
+ public:
+  AutoTuner(DBImpl* db, std::shared_ptr<TuningPolicy> policy,
+            uint64_t period_sec, uint64_t gap_sec);
+  ~AutoTuner();
+
+  AutoTuner(const AutoTuner&) = delete;
+  AutoTuner& operator=(const AutoTuner&) = delete;
+
+  void Tick();
+
+  uint64_t TuningRounds() const {
+    return tuning_rounds_.load(std::memory_order_relaxed);
+  }
+  FEAT_Tuner* GetTuner() { return tuner_.get(); }
+
+ private:
+  DBImpl* db_;
+  const uint64_t period_sec_;
+  const uint64_t gap_sec_;
+  uint64_t secs_elapsed_;
+  std::atomic<uint64_t> tuning_rounds_;
+  std::unique_ptr<FEAT_Tuner> tuner_;
+  std::unique_ptr<TuningExecutor> executor_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
+
+#endif  // ROCKSDB_LITE
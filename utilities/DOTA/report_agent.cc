@@ -5,16 +5,22 @@
 #include "rocksdb/utilities/report_agent.h"
 
 #include "rocksdb/utilities/DOTA_tuner.h"
+#include "utilities/counted_fs.h"
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 
 namespace ROCKSDB_NAMESPACE {
-ReporterAgent::~ReporterAgent() {
+ReporterAgent::~ReporterAgent() { StopReporting(); }
+void ReporterAgent::StopReporting() {
   {
     std::unique_lock<std::mutex> lk(mutex_);
     stop_ = true;
     stop_cv_.notify_all();
   }
-  reporting_thread_.join();
+  if (reporting_thread_.joinable()) {
+    reporting_thread_.join();
+  }
 }
 void ReporterAgent::InsertNewTuningPoints(ChangePoint point) {
   std::cout << "can't use change point @ " << point.change_timing
@@ -29,17 +35,148 @@ Status ReporterAgent::ReportLine(int secs_elapsed,
   return s;
 }
 
+TuningExecutor::TuningExecutor(DBImpl* running_db, size_t max_pending_options)
+    : running_db_(running_db),
+      max_pending_options_(max_pending_options),
+      num_pending_options_(0),
+      applying_(false),
+      stop_(false),
+      last_apply_micros_(0),
+      applied_batches_(0) {
+  thread_ = port::Thread([this]() { Run(); });
+}
+
+TuningExecutor::~TuningExecutor() {
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    stop_ = true;
+    // the DB may be closing, drop what has not started yet
+    pending_db_options_.clear();
+    pending_cf_options_.clear();
+    num_pending_options_ = 0;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+size_t TuningExecutor::Submit(const std::vector<ChangePoint>& points) {
+  size_t dropped = 0;
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (const auto& point : points) {
+      auto& pending = point.db_width ? pending_db_options_
+                                     : pending_cf_options_[point.cf_id];
+      auto it = pending.find(point.opt);
+      if (it != pending.end()) {
+        it->second = point.value;
+      } else if (pending.size() < max_pending_options_) {
+        pending.emplace(point.opt, point.value);
+        num_pending_options_++;
+      } else {
+        dropped++;
+      }
+    }
+  }
+  cv_.notify_one();
+  return dropped;
+}
+
+bool TuningExecutor::Busy() const {
+  std::unique_lock<std::mutex> lk(mu_);
+  return applying_ || num_pending_options_ > 0;
+}
+
+Status TuningExecutor::LastApplyStatus() const {
+  std::unique_lock<std::mutex> lk(mu_);
+  return last_status_;
+}
+
+void TuningExecutor::Run() {
+  std::unordered_map<std::string, std::string> db_options;
+  std::map<uint32_t, std::unordered_map<std::string, std::string>> cf_options;
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    cv_.wait(lk, [this]() { return stop_ || num_pending_options_ > 0; });
+    if (stop_) {
+      break;
+    }
+    db_options.swap(pending_db_options_);
+    cf_options.swap(pending_cf_options_);
+    num_pending_options_ = 0;
+    applying_ = true;
+    lk.unlock();
+
+    const auto start = std::chrono::steady_clock::now();
+    Status s;
+    Status rate_limit_s;
+    auto rate_limit = db_options.find(kRateLimiterBytesPerSec);
+    if (rate_limit != db_options.end()) {
+      const auto& limiter = running_db_->immutable_db_options().rate_limiter;
+      if (limiter == nullptr) {
+        rate_limit_s = Status::InvalidArgument("the DB has no rate limiter");
+      } else {
+        limiter->SetBytesPerSecond(static_cast<int64_t>(
+            std::strtoull(rate_limit->second.c_str(), nullptr, 10)));
+      }
+      db_options.erase(rate_limit);
+    }
+    if (!db_options.empty()) {
+      s = running_db_->SetDBOptions(db_options);
+    }
+    for (const auto& cf : cf_options) {
+      if (cf.second.empty()) {
+        continue;
+      }
+      Status cf_s;
+      auto handle = running_db_->GetColumnFamilyHandleUnlocked(cf.first);
+      if (handle == nullptr) {
+        cf_s = Status::InvalidArgument("column family dropped");
+      } else {
+        cf_s = running_db_->SetOptions(handle.get(), cf.second);
+      }
+      if (s.ok()) {
+        s = cf_s;
+      }
+    }
+    if (s.ok()) {
+      s = rate_limit_s;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    if (!s.ok()) {
+      std::cout << "failed to apply tuning changes: " << s.ToString()
+                << std::endl;
+    }
+    db_options.clear();
+    cf_options.clear();
+
+    lk.lock();
+    last_status_ = s;
+    applying_ = false;
+    last_apply_micros_.store(static_cast<uint64_t>(elapsed.count()),
+                             std::memory_order_release);
+    applied_batches_.fetch_add(1, std::memory_order_acq_rel);
+  }
+}
+
 void ReporterAgentWithTuning::DetectChangesPoints(int sec_elapsed) {
   std::vector<ChangePoint> change_points;
-  if (applying_changes) {
+  if (executor_->Busy()) {
+    // the previous decision has not landed yet, scoring now would judge it
+    // before it took effect
     return;
   }
+  tuner->ReportApplyLatency(executor_->LastApplyMicros());
   tuner->DetectTuningOperations(sec_elapsed, &change_points);
   ApplyChangePointsInstantly(&change_points);
 }
 
 void ReporterAgentWithTuning::DetectAndTuning(int secs_elapsed) {
+  std::lock_guard<std::mutex> lk(tuning_mu_);
   if (secs_elapsed % tuning_gap_secs_ == 0) {
+    if (trigger_ != nullptr) {
+      trigger_->MarkRound();
+    }
     DetectChangesPoints(secs_elapsed);
     //    this->running_db_->immutable_db_options().job_stats->clear();
     last_metrics_collect_secs = secs_elapsed;
@@ -54,27 +191,33 @@ void ReporterAgentWithTuning::DetectAndTuning(int secs_elapsed) {
 
 Status ReporterAgentWithTuning::ReportLine(int secs_elapsed,
                                            int total_ops_done_snapshot) {
-  auto opt = this->running_db_->GetOptions();
+  TuningSnapshot snapshot;
+  auto s = this->running_db_->GetTuningSnapshot(&snapshot);
+  if (!s.ok()) {
+    return s;
+  }
 
-  uint64_t memtable_mb = opt.write_buffer_size >> 20;
-  uint64_t sstable_mb = opt.target_file_size_base >> 20;
-  int flush_threads =
-      tuner ? std::max(0, tuner->CurrentFlushThreads()) : 0;
-  int compaction_threads =
-      tuner ? std::max(0, tuner->CurrentCompactionThreads()) : 0;
+  uint64_t memtable_mb = snapshot.write_buffer_size >> 20;
+  uint64_t sstable_mb = snapshot.target_file_size_base >> 20;
+  int flush_threads = 0;
+  int compaction_threads = 0;
+  {
+    // the event thread may be tuning
+    std::lock_guard<std::mutex> lk(tuning_mu_);
+    if (tuner) {
+      flush_threads = std::max(0, tuner->CurrentFlushThreads());
+      compaction_threads = std::max(0, tuner->CurrentCompactionThreads());
+    }
+  }
 
-  // Fallback: if tuner doesn't maintain split counts, derive from DB options.
+  // Fallback: if tuner doesn't maintain split counts, take the DB's limits.
   if (flush_threads <= 0 && compaction_threads <= 0) {
-    flush_threads = opt.max_background_flushes > 0 ? opt.max_background_flushes
-                                                   : opt.max_background_jobs;
-    compaction_threads =
-        opt.max_background_compactions > 0 ? opt.max_background_compactions
-                                           : opt.max_background_jobs;
+    flush_threads = snapshot.max_background_flushes;
+    compaction_threads = snapshot.max_background_compactions;
   }
 
   if (report_total_threads_only_) {
-    int total_threads = opt.max_background_jobs > 0 ? opt.max_background_jobs
-                                                    : 0;
+    int total_threads = snapshot.max_background_jobs;
     if (total_threads <= 0) {
       total_threads = flush_threads + compaction_threads;
     }
@@ -83,8 +226,7 @@ Status ReporterAgentWithTuning::ReportLine(int secs_elapsed,
         std::to_string(total_ops_done_snapshot - last_report_) + "," +
         std::to_string(memtable_mb) + "," + std::to_string(sstable_mb) + "," +
         std::to_string(total_threads);
-    auto s = report_file_->Append(report);
-    return s;
+    return report_file_->Append(report);
   }
 
   std::string report =
@@ -93,37 +235,34 @@ Status ReporterAgentWithTuning::ReportLine(int secs_elapsed,
       std::to_string(memtable_mb) + "," + std::to_string(sstable_mb) + "," +
       std::to_string(flush_threads) + "," +
       std::to_string(compaction_threads);
-  auto s = report_file_->Append(report);
-  return s;
+  return report_file_->Append(report);
 }
 void ReporterAgentWithTuning::UseFEATTuner(bool TEA_enable, bool FEA_enable,
                                            bool ark_enable) {
-  tuner.release();
-  tuner.reset(new FEAT_Tuner(options_when_boost, running_db_, &last_report_,
-                             &total_ops_done_, env_, tuning_gap_secs_,
-                             TEA_enable, FEA_enable, ark_enable));
+  UseTuningPolicy(TuningPolicy::FromFlags(TEA_enable, FEA_enable, ark_enable));
 };
 
-Status update_db_options(
-    DBImpl* running_db_,
-    std::unordered_map<std::string, std::string>* new_db_options,
-    bool* applying_changes, Env* /*env*/) {
-  *applying_changes = true;
-  Status s = running_db_->SetDBOptions(*new_db_options);
-  free(new_db_options);
-  *applying_changes = false;
-  return s;
-}
-
-Status update_cf_options(
-    DBImpl* running_db_,
-    std::unordered_map<std::string, std::string>* new_cf_options,
-    bool* applying_changes, Env* /*env*/) {
-  *applying_changes = true;
-  Status s = running_db_->SetOptions(*new_cf_options);
-  free(new_cf_options);
-  *applying_changes = false;
-  return s;
+void ReporterAgentWithTuning::UseTuningPolicy(
+    std::shared_ptr<TuningPolicy> policy) {
+  std::lock_guard<std::mutex> lk(tuning_mu_);
+  auto feat_tuner = new FEAT_Tuner(options_when_boost, running_db_,
+                                   &last_report_, &total_ops_done_, env_,
+                                   tuning_gap_secs_, std::move(policy));
+  tuner.reset(feat_tuner);
+  const auto& trace_file = running_db_->immutable_db_options().tuner_trace_file;
+  if (!trace_file.empty()) {
+    Status s = feat_tuner->StartTrace(env_, trace_file);
+    if (!s.ok()) {
+      std::cout << "can't trace the tuner: " << s.ToString() << std::endl;
+    }
+  }
+  const auto& state_file = running_db_->immutable_db_options().tuner_state_file;
+  if (!state_file.empty()) {
+    Status s = feat_tuner->ResumeFrom(state_file);
+    if (!s.ok()) {
+      std::cout << "can't resume the tuner: " << s.ToString() << std::endl;
+    }
+  }
 }
 
 Status SILK_pause_compaction(DBImpl* running_db_, bool* stopped) {
@@ -140,34 +279,42 @@ Status SILK_resume_compaction(DBImpl* running_db_, bool* stopped) {
 
 void ReporterAgentWithTuning::ApplyChangePointsInstantly(
     std::vector<ChangePoint>* points) {
-  std::unordered_map<std::string, std::string>* new_cf_options;
-  std::unordered_map<std::string, std::string>* new_db_options;
-
-  new_cf_options = new std::unordered_map<std::string, std::string>();
-  new_db_options = new std::unordered_map<std::string, std::string>();
   if (points->empty()) {
     return;
   }
-
-  for (auto point : *points) {
-    if (point.db_width) {
-      new_db_options->emplace(point.opt, point.value);
-    } else {
-      new_cf_options->emplace(point.opt, point.value);
-    }
+  size_t dropped = executor_->Submit(*points);
+  if (dropped > 0) {
+    std::cout << "tuning queue full, dropped " << dropped << " changes"
+              << std::endl;
   }
   points->clear();
-  Status s;
-  if (!new_db_options->empty()) {
-    //    std::thread t();
-    std::thread t(update_db_options, running_db_, new_db_options,
-                  &applying_changes, env_);
-    t.detach();
+}
+
+ReporterAgentWithTuning::~ReporterAgentWithTuning() {
+  // DetectAndTuning() runs on the reporting thread and uses the executor
+  StopReporting();
+  if (event_thread_.joinable()) {
+    stop_events_.store(true, std::memory_order_release);
+    trigger_->WakeUp();
+    event_thread_.join();
   }
-  if (!new_cf_options->empty()) {
-    std::thread t(update_cf_options, running_db_, new_cf_options,
-                  &applying_changes, env_);
-    t.detach();
+  executor_.reset();
+}
+
+void ReporterAgentWithTuning::WaitForTuningEvents() {
+  while (!stop_events_.load(std::memory_order_acquire)) {
+    // the timeout only bounds how long stopping may take
+    if (trigger_->Wait(kMicrosInSecond) == TuningTrigger::kNoReason) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lk(tuning_mu_);
+    if (stop_events_.load(std::memory_order_acquire)) {
+      break;
+    }
+    auto secs_elapsed =
+        (env_->NowMicros() - events_started_micros_ + kMicrosInSecond / 2) /
+        kMicrosInSecond;
+    DetectChangesPoints(static_cast<int>(secs_elapsed));
   }
 }
 
@@ -179,6 +326,8 @@ ReporterAgentWithTuning::ReporterAgentWithTuning(DBImpl* running_db, Env* env,
     : ReporterAgent(env, fname, report_interval_secs,
                     report_total_threads_only ? ADOCHeader() : DOTAHeader()),
       options_when_boost(running_db->GetOptions()),
+      stop_events_(false),
+      events_started_micros_(env->NowMicros()),
       report_total_threads_only_(report_total_threads_only) {
   tuning_points = std::vector<ChangePoint>();
   tuning_points.clear();
@@ -193,10 +342,19 @@ ReporterAgentWithTuning::ReporterAgentWithTuning(DBImpl* running_db, Env* env,
   this->last_metrics_collect_secs = 0;
   this->last_compaction_thread_len = 0;
   this->last_flush_thread_len = 0;
-  tuner.reset(new DOTA_Tuner(options_when_boost, running_db_, &last_report_,
-                             &total_ops_done_, env_, tuning_gap_secs_));
+  const auto& policy = running_db_->immutable_db_options().tuning_policy;
+  if (policy != nullptr) {
+    UseTuningPolicy(policy);
+  } else {
+    tuner.reset(new DOTA_Tuner(options_when_boost, running_db_, &last_report_,
+                               &total_ops_done_, env_, tuning_gap_secs_));
+  }
   tuner->ResetTuner();
-  this->applying_changes = false;
+  executor_.reset(new TuningExecutor(running_db_));
+  trigger_ = running_db_->immutable_db_options().tuning_trigger;
+  if (trigger_ != nullptr) {
+    event_thread_ = port::Thread([this]() { WaitForTuningEvents(); });
+  }
 }
 
 inline double average(std::vector<double>& v) {
@@ -230,10 +388,25 @@ Status ReporterAgentWithSILK::ReportLine(int secs_elapsed,
   long cur_throughput = (total_ops_done_snapshot - last_report_);
   long cur_bandwidth_user_ops_MBPS =
       cur_throughput * FLAGS_value_size / 1000000;
+  // Once the DB learned what its device sustains, that is the limitation.
+  long bandwidth_limitation = FLAGS_SILK_bandwidth_limitation;
+  const auto& tuning_fs = running_db_->immutable_db_options().tuning_fs;
+  if (tuning_fs != nullptr) {
+    TuningSnapshot snapshot;
+    const bool busy = running_db_->GetTuningSnapshot(&snapshot).ok() &&
+                      (snapshot.immutable_memtables > 0 ||
+                       snapshot.write_delayed || snapshot.write_stopped);
+    bandwidth_.Update(tuning_fs->counters()->writes.bytes.load(),
+                      tuning_fs->counters()->reads.bytes.load(),
+                      static_cast<double>(report_interval_secs_), busy);
+    if (bandwidth_.SustainableMBps() > 0) {
+      bandwidth_limitation = static_cast<long>(bandwidth_.SustainableMBps());
+    }
+  }
 
   // SILK TESTING the Pause compaction work functionality
   if (!pausedcompaction &&
-      cur_bandwidth_user_ops_MBPS > FLAGS_SILK_bandwidth_limitation * 0.75) {
+      cur_bandwidth_user_ops_MBPS > bandwidth_limitation * 0.75) {
     // SILK Consider this a load peak
     //    running_db_->PauseCompactionWork();
     //    pausedcompaction = true;
@@ -241,14 +414,14 @@ Status ReporterAgentWithSILK::ReportLine(int secs_elapsed,
     std::thread t(SILK_pause_compaction, running_db_, &pausedcompaction);
     t.detach();
 
-  } else if (pausedcompaction && cur_bandwidth_user_ops_MBPS <=
-                                     FLAGS_SILK_bandwidth_limitation * 0.75) {
+  } else if (pausedcompaction &&
+             cur_bandwidth_user_ops_MBPS <= bandwidth_limitation * 0.75) {
     std::thread t(SILK_resume_compaction, running_db_, &pausedcompaction);
     t.detach();
   }
 
   long cur_bandiwdth_compaction_MBPS =
-      FLAGS_SILK_bandwidth_limitation -
+      bandwidth_limitation -
       cur_bandwidth_user_ops_MBPS;  // measured 200MB/s SSD bandwidth on XEON.
   if (cur_bandiwdth_compaction_MBPS < 10) {
     cur_bandiwdth_compaction_MBPS = 10;
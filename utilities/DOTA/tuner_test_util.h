@@ -0,0 +1,93 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "rocksdb/convenience.h"
+#include "rocksdb/utilities/tuning_policy.h"
+#include "test_util/testharness.h"
+#include "utilities/DOTA/tuner_trace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// What the tuner tests share: ARK tuners without a DB, fed one recorded
+// round after the other through FEAT_Tuner::ReplayRound().
+class TunerTestBase : public testing::Test {
+ public:
+  TunerTestBase() : env_(Env::Default()) {
+    EXPECT_OK(
+        TuningPolicy::CreateFromString(ConfigOptions(), "ARK", &policy_));
+  }
+
+  static TunerTraceHeader Header() {
+    TunerTraceHeader header;
+    header.policy = "ARK";
+    header.tuning_gap = 1;
+    header.core_number = 8;
+    header.max_memtable_size = 512 << 20;
+    header.write_buffer_size = 64 << 20;
+    header.target_file_size_base = 64 << 20;
+    header.max_background_jobs = 4;
+    return header;
+  }
+
+  // A write burst: memtable pressure in the middle rounds, then a compaction
+  // backlog.
+  static std::vector<TunerTraceRecord> Inputs() {
+    std::vector<TunerTraceRecord> inputs;
+    for (int i = 0; i < 12; i++) {
+      TunerTraceRecord input;
+      input.secs_elapsed = i + 1;
+      input.scores.flush_speed_avg = i >= 4 && i < 8 ? 40 : 100;
+      input.scores.memtable_speed = 64;
+      input.scores.flush_numbers = 2;
+      ColumnFamilyTuningState cf;
+      cf.id = 0;
+      cf.name = "default";
+      cf.immutable_number = i >= 4 && i < 8 ? 1 : 0;
+      cf.active_size_ratio = 0.3;
+      cf.l0_num = i >= 8 ? 1.5 : 0.2;
+      cf.flush_numbers = 2;
+      cf.write_buffer_size = 64 << 20;
+      cf.target_file_size_base = 64 << 20;
+      cf.max_write_buffer_number = 2;
+      cf.min_write_buffer_number_to_merge = 1;
+      cf.level0_file_num_compaction_trigger = 4;
+      input.cf_states.push_back(cf);
+      input.scores.immutable_number = cf.immutable_number;
+      input.scores.l0_num = cf.l0_num;
+      input.flush_threads = 1;
+      input.compaction_threads = 3;
+      input.max_background_jobs = 4;
+      input.write_buffer_size = 64 << 20;
+      inputs.push_back(input);
+    }
+    return inputs;
+  }
+
+  std::unique_ptr<FEAT_Tuner> NewTuner(
+      const TunerTraceHeader& header = Header()) {
+    return std::unique_ptr<FEAT_Tuner>(new FEAT_Tuner(header, env_, policy_));
+  }
+
+  // The outputs of a fresh tuner fed with `inputs`.
+  std::vector<TunerTraceRecord> Replay(
+      const std::vector<TunerTraceRecord>& inputs) {
+    auto tuner = NewTuner();
+    std::vector<TunerTraceRecord> outputs(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+      tuner->ReplayRound(inputs[i], &outputs[i]);
+    }
+    return outputs;
+  }
+
+  Env* env_;
+  std::shared_ptr<TuningPolicy> policy_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
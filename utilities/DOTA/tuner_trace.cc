@@ -0,0 +1,581 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "utilities/DOTA/tuner_trace.h"
+
+#include <cstring>
+#include <sstream>
+
+#include "file/filename.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+const char kTunerTraceMagic[] = "ARKTRACE";
+const size_t kTunerTraceMagicSize = sizeof(kTunerTraceMagic) - 1;
+const uint32_t kTraceVersion = 9;
+const char kTunerStateMagic[] = "ARKSTATE";
+const size_t kTunerStateMagicSize = sizeof(kTunerStateMagic) - 1;
+// The layout of the state itself. The scores and the column families are
+// encoded as in the trace records, so a state is only read back when it was
+// also written with the same kTraceVersion.
+const uint32_t kTunerStateVersion = 2;
+
+void PutDouble(std::string* dst, double value) {
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(value), "unexpected double size");
+  std::memcpy(&bits, &value, sizeof(bits));
+  PutFixed64(dst, bits);
+}
+
+bool GetDouble(Slice* input, double* value) {
+  uint64_t bits;
+  if (!GetFixed64(input, &bits)) {
+    return false;
+  }
+  std::memcpy(value, &bits, sizeof(bits));
+  return true;
+}
+
+void PutInt(std::string* dst, int value) {
+  PutFixed32(dst, static_cast<uint32_t>(value));
+}
+
+bool GetInt(Slice* input, int* value) {
+  uint32_t v;
+  if (!GetFixed32(input, &v)) {
+    return false;
+  }
+  *value = static_cast<int>(v);
+  return true;
+}
+
+bool GetOp(Slice* input, OpType* op) {
+  uint32_t v;
+  if (!GetVarint32(input, &v) || v > kKeep) {
+    return false;
+  }
+  *op = static_cast<OpType>(v);
+  return true;
+}
+
+bool GetBool(Slice* input, bool* value) {
+  uint32_t v;
+  if (!GetVarint32(input, &v)) {
+    return false;
+  }
+  *value = v != 0;
+  return true;
+}
+
+bool GetString(Slice* input, std::string* value) {
+  Slice s;
+  if (!GetLengthPrefixedSlice(input, &s)) {
+    return false;
+  }
+  value->assign(s.data(), s.size());
+  return true;
+}
+
+void PutScores(std::string* dst, const SystemScores& s) {
+  PutFixed64(dst, s.memtable_speed);
+  PutDouble(dst, s.active_size_ratio);
+  PutInt(dst, s.immutable_number);
+  PutDouble(dst, s.flush_speed_avg);
+  PutDouble(dst, s.flush_min);
+  PutDouble(dst, s.flush_speed_var);
+  PutDouble(dst, s.l0_num);
+  PutDouble(dst, s.l0_drop_ratio);
+  PutDouble(dst, s.estimate_compaction_bytes);
+  PutDouble(dst, s.disk_bandwidth);
+  PutDouble(dst, s.flush_idle_time);
+  PutDouble(dst, s.flush_gap_time);
+  PutDouble(dst, s.compaction_idle_time);
+  PutInt(dst, s.flush_numbers);
+  PutDouble(dst, s.interval_qps);
+  PutDouble(dst, s.stall_ratio);
+  PutDouble(dst, s.write_latency_p99);
+  PutDouble(dst, s.read_latency_p99);
+  PutDouble(dst, s.io_utilization);
+}
+
+bool GetScores(Slice* input, SystemScores* s) {
+  return GetFixed64(input, &s->memtable_speed) &&
+         GetDouble(input, &s->active_size_ratio) &&
+         GetInt(input, &s->immutable_number) &&
+         GetDouble(input, &s->flush_speed_avg) &&
+         GetDouble(input, &s->flush_min) &&
+         GetDouble(input, &s->flush_speed_var) &&
+         GetDouble(input, &s->l0_num) && GetDouble(input, &s->l0_drop_ratio) &&
+         GetDouble(input, &s->estimate_compaction_bytes) &&
+         GetDouble(input, &s->disk_bandwidth) &&
+         GetDouble(input, &s->flush_idle_time) &&
+         GetDouble(input, &s->flush_gap_time) &&
+         GetDouble(input, &s->compaction_idle_time) &&
+         GetInt(input, &s->flush_numbers) &&
+         GetDouble(input, &s->interval_qps) &&
+         GetDouble(input, &s->stall_ratio) &&
+         GetDouble(input, &s->write_latency_p99) &&
+         GetDouble(input, &s->read_latency_p99) &&
+         GetDouble(input, &s->io_utilization);
+}
+
+void PutCounters(std::string* dst, const ArkCounters& c) {
+  PutInt(dst, c.memtable_pressure_score);
+  PutInt(dst, c.compaction_pressure_score);
+  PutInt(dst, c.memtable_relax_counter);
+  PutInt(dst, c.compaction_relax_counter);
+  PutInt(dst, c.stall_suspect_counter);
+}
+
+bool GetCounters(Slice* input, ArkCounters* c) {
+  return GetInt(input, &c->memtable_pressure_score) &&
+         GetInt(input, &c->compaction_pressure_score) &&
+         GetInt(input, &c->memtable_relax_counter) &&
+         GetInt(input, &c->compaction_relax_counter) &&
+         GetInt(input, &c->stall_suspect_counter);
+}
+
+void PutColumnFamily(std::string* dst, const ColumnFamilyTuningState& cf) {
+  PutFixed32(dst, cf.id);
+  PutLengthPrefixedSlice(dst, cf.name);
+  PutDouble(dst, cf.active_size_ratio);
+  PutInt(dst, cf.immutable_number);
+  PutDouble(dst, cf.l0_num);
+  PutDouble(dst, cf.estimate_compaction_bytes);
+  PutInt(dst, cf.flush_numbers);
+  PutFixed64(dst, cf.write_buffer_size);
+  PutFixed64(dst, cf.target_file_size_base);
+  PutInt(dst, cf.max_write_buffer_number);
+  PutInt(dst, cf.min_write_buffer_number_to_merge);
+  PutInt(dst, cf.level0_file_num_compaction_trigger);
+  PutInt(dst, cf.level0_slowdown_writes_trigger);
+  PutInt(dst, cf.level0_stop_writes_trigger);
+  PutFixed64(dst, cf.soft_pending_compaction_bytes_limit);
+  PutFixed64(dst, cf.hard_pending_compaction_bytes_limit);
+  PutInt(dst, cf.base_level0_slowdown_writes_trigger);
+  PutInt(dst, cf.base_level0_stop_writes_trigger);
+  PutFixed64(dst, cf.base_soft_pending_compaction_bytes_limit);
+  PutFixed64(dst, cf.base_hard_pending_compaction_bytes_limit);
+  const auto& limits = cf.max_compactions_per_output_level;
+  PutVarint32(dst, static_cast<uint32_t>(limits.size()));
+  for (int limit : limits) {
+    PutInt(dst, limit);
+  }
+  PutInt(dst, cf.num_levels);
+  PutInt(dst, cf.base_level);
+  PutInt(dst, cf.compaction_pressure_score);
+  PutInt(dst, cf.compaction_relax_counter);
+  PutInt(dst, cf.memtable_relax_counter);
+  PutVarint32(dst, cf.memtable_pressure ? 1 : 0);
+  PutVarint32(dst, cf.batch_op);
+  PutVarint32(dst, cf.sstable_op);
+  PutVarint32(dst, cf.write_buffer_number_op);
+  PutVarint32(dst, cf.merge_width_op);
+  PutDouble(dst, cf.prev_l0_num);
+  PutDouble(dst, cf.prev_estimate_compaction_bytes);
+  PutInt(dst, cf.l0_growth_rounds);
+  PutVarint32(dst, cf.stall_limit_op);
+  PutVarint32(dst, cf.deep_compaction_op);
+}
+
+bool GetLimits(Slice* input, std::vector<int>* limits) {
+  uint32_t count;
+  if (!GetVarint32(input, &count) || count > input->size() / sizeof(int)) {
+    return false;
+  }
+  limits->resize(count);
+  for (auto& limit : *limits) {
+    if (!GetInt(input, &limit)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool GetColumnFamily(Slice* input, ColumnFamilyTuningState* cf) {
+  return GetFixed32(input, &cf->id) && GetString(input, &cf->name) &&
+         GetDouble(input, &cf->active_size_ratio) &&
+         GetInt(input, &cf->immutable_number) &&
+         GetDouble(input, &cf->l0_num) &&
+         GetDouble(input, &cf->estimate_compaction_bytes) &&
+         GetInt(input, &cf->flush_numbers) &&
+         GetFixed64(input, &cf->write_buffer_size) &&
+         GetFixed64(input, &cf->target_file_size_base) &&
+         GetInt(input, &cf->max_write_buffer_number) &&
+         GetInt(input, &cf->min_write_buffer_number_to_merge) &&
+         GetInt(input, &cf->level0_file_num_compaction_trigger) &&
+         GetInt(input, &cf->level0_slowdown_writes_trigger) &&
+         GetInt(input, &cf->level0_stop_writes_trigger) &&
+         GetFixed64(input, &cf->soft_pending_compaction_bytes_limit) &&
+         GetFixed64(input, &cf->hard_pending_compaction_bytes_limit) &&
+         GetInt(input, &cf->base_level0_slowdown_writes_trigger) &&
+         GetInt(input, &cf->base_level0_stop_writes_trigger) &&
+         GetFixed64(input, &cf->base_soft_pending_compaction_bytes_limit) &&
+         GetFixed64(input, &cf->base_hard_pending_compaction_bytes_limit) &&
+         GetLimits(input, &cf->max_compactions_per_output_level) &&
+         GetInt(input, &cf->num_levels) && GetInt(input, &cf->base_level) &&
+         GetInt(input, &cf->compaction_pressure_score) &&
+         GetInt(input, &cf->compaction_relax_counter) &&
+         GetInt(input, &cf->memtable_relax_counter) &&
+         GetBool(input, &cf->memtable_pressure) &&
+         GetOp(input, &cf->batch_op) && GetOp(input, &cf->sstable_op) &&
+         GetOp(input, &cf->write_buffer_number_op) &&
+         GetOp(input, &cf->merge_width_op) &&
+         GetDouble(input, &cf->prev_l0_num) &&
+         GetDouble(input, &cf->prev_estimate_compaction_bytes) &&
+         GetInt(input, &cf->l0_growth_rounds) &&
+         GetOp(input, &cf->stall_limit_op) &&
+         GetOp(input, &cf->deep_compaction_op);
+}
+
+void PutTuningOp(std::string* dst, const TuningOP& op) {
+  PutVarint32(dst, op.BatchOp);
+  PutVarint32(dst, op.ThreadOp);
+  PutVarint32(dst, op.FlushThreadOp);
+  PutVarint32(dst, op.CompactionThreadOp);
+  PutVarint32(dst, op.SSTableOp);
+  PutVarint32(dst, op.RateLimitOp);
+  PutVarint32(dst, op.WriteBufferNumberOp);
+  PutVarint32(dst, op.MergeWidthOp);
+  PutVarint32(dst, op.StallLimitOp);
+  PutVarint32(dst, op.DeepCompactionOp);
+}
+
+bool GetTuningOp(Slice* input, TuningOP* op) {
+  return GetOp(input, &op->BatchOp) && GetOp(input, &op->ThreadOp) &&
+         GetOp(input, &op->FlushThreadOp) &&
+         GetOp(input, &op->CompactionThreadOp) &&
+         GetOp(input, &op->SSTableOp) && GetOp(input, &op->RateLimitOp) &&
+         GetOp(input, &op->WriteBufferNumberOp) &&
+         GetOp(input, &op->MergeWidthOp) &&
+         GetOp(input, &op->StallLimitOp) &&
+         GetOp(input, &op->DeepCompactionOp);
+}
+
+Status Corrupted(const char* what) {
+  return Status::Corruption("bad tuner trace", what);
+}
+}  // namespace
+
+std::string TunerTraceRecord::DecisionString() const {
+  std::ostringstream ss;
+  if (!decided) {
+    ss << "no decision";
+  } else {
+    ss << "ops(flush/comp/batch/sstable/thread/rate_limit/slots/merge/"
+          "stall_limit/deep_compaction)="
+       << OpString(op.FlushThreadOp) << "/"
+       << OpString(op.CompactionThreadOp) << "/" << OpString(op.BatchOp)
+       << "/" << OpString(op.SSTableOp) << "/" << OpString(op.ThreadOp)
+       << "/" << OpString(op.RateLimitOp) << "/"
+       << OpString(op.WriteBufferNumberOp) << "/"
+       << OpString(op.MergeWidthOp) << "/" << OpString(op.StallLimitOp)
+       << "/" << OpString(op.DeepCompactionOp);
+  }
+  for (const auto& point : change_points) {
+    ss << " " << point.opt;
+    if (!point.db_width) {
+      ss << "[cf " << point.cf_id << "]";
+    }
+    ss << "=" << point.value;
+  }
+  return ss.str();
+}
+
+void EncodeTunerState(const TunerState& state, std::string* dst) {
+  PutScores(dst, state.max_scores);
+  PutScores(dst, state.avg_scores);
+  PutCounters(dst, state.counters);
+  PutInt(dst, state.max_thread);
+  PutInt(dst, state.flush_threads);
+  PutInt(dst, state.compaction_threads);
+  PutFixed64(dst, state.rate_limit);
+  PutVarint32(dst, static_cast<uint32_t>(state.workload_phase));
+  PutVarint32(dst, static_cast<uint32_t>(state.cf_states.size()));
+  for (const auto& cf : state.cf_states) {
+    PutColumnFamily(dst, cf);
+  }
+}
+
+Status DecodeTunerState(Slice input, TunerState* state) {
+  uint32_t phase = 0;
+  uint32_t num_cfs = 0;
+  if (!GetScores(&input, &state->max_scores) ||
+      !GetScores(&input, &state->avg_scores) ||
+      !GetCounters(&input, &state->counters) ||
+      !GetInt(&input, &state->max_thread) ||
+      !GetInt(&input, &state->flush_threads) ||
+      !GetInt(&input, &state->compaction_threads) ||
+      !GetFixed64(&input, &state->rate_limit) ||
+      !GetVarint32(&input, &phase) || phase > TuningWorkload::kMixed ||
+      !GetVarint32(&input, &num_cfs)) {
+    return Status::Corruption("bad tuner state", "tuner");
+  }
+  state->workload_phase = static_cast<TuningWorkload::Phase>(phase);
+  state->cf_states.clear();
+  for (uint32_t i = 0; i < num_cfs; i++) {
+    ColumnFamilyTuningState cf;
+    if (!GetColumnFamily(&input, &cf)) {
+      return Status::Corruption("bad tuner state", "column family");
+    }
+    state->cf_states.push_back(std::move(cf));
+  }
+  return Status::OK();
+}
+
+Status WriteTunerState(Env* env, const std::string& path,
+                       const TunerState& state) {
+  std::string encoded;
+  EncodeTunerState(state, &encoded);
+  std::string data(kTunerStateMagic, kTunerStateMagicSize);
+  PutFixed32(&data, kTunerStateVersion);
+  PutFixed32(&data, kTraceVersion);
+  PutFixed32(&data, crc32c::Mask(crc32c::Value(encoded.data(),
+                                               encoded.size())));
+  data.append(encoded);
+  const std::string tmp = path + "." + kTempFileNameSuffix;
+  Status s = WriteStringToFile(env, data, tmp, true /* should_sync */);
+  if (s.ok()) {
+    s = env->RenameFile(tmp, path);
+  }
+  if (!s.ok()) {
+    env->DeleteFile(tmp).PermitUncheckedError();
+  }
+  return s;
+}
+
+Status ReadTunerState(Env* env, const std::string& path, TunerState* state) {
+  std::string data;
+  Status s = ReadFileToString(env, path, &data);
+  if (!s.ok()) {
+    return s;
+  }
+  Slice input(data);
+  uint32_t version = 0;
+  uint32_t trace_version = 0;
+  uint32_t crc = 0;
+  if (!input.starts_with(Slice(kTunerStateMagic, kTunerStateMagicSize))) {
+    return Status::InvalidArgument(path, "not a tuner state");
+  }
+  input.remove_prefix(kTunerStateMagicSize);
+  if (!GetFixed32(&input, &version) || version != kTunerStateVersion ||
+      !GetFixed32(&input, &trace_version) || trace_version != kTraceVersion) {
+    return Status::NotSupported("unknown tuner state version");
+  }
+  if (!GetFixed32(&input, &crc) ||
+      crc32c::Unmask(crc) != crc32c::Value(input.data(), input.size())) {
+    return Status::Corruption("bad tuner state", "checksum mismatch");
+  }
+  return DecodeTunerState(input, state);
+}
+
+void EncodeTunerTraceHeader(const TunerTraceHeader& header,
+                            std::string* dst) {
+  PutLengthPrefixedSlice(dst, header.policy);
+  PutFixed64(dst, header.tuning_gap);
+  PutFixed64(dst, header.core_number);
+  PutFixed64(dst, header.max_memtable_size);
+  PutFixed64(dst, header.write_buffer_size);
+  PutFixed64(dst, header.target_file_size_base);
+  PutInt(dst, header.max_background_jobs);
+  PutInt(dst, header.max_background_flushes);
+  PutInt(dst, header.max_background_compactions);
+  PutVarint32(dst, static_cast<uint32_t>(header.objective));
+  PutFixed64(dst, header.rate_limit_bytes_per_sec);
+}
+
+Status DecodeTunerTraceHeader(Slice input, TunerTraceHeader* header) {
+  if (!GetString(&input, &header->policy) ||
+      !GetFixed64(&input, &header->tuning_gap) ||
+      !GetFixed64(&input, &header->core_number) ||
+      !GetFixed64(&input, &header->max_memtable_size) ||
+      !GetFixed64(&input, &header->write_buffer_size) ||
+      !GetFixed64(&input, &header->target_file_size_base) ||
+      !GetInt(&input, &header->max_background_jobs) ||
+      !GetInt(&input, &header->max_background_flushes) ||
+      !GetInt(&input, &header->max_background_compactions)) {
+    return Corrupted("header");
+  }
+  uint32_t objective;
+  if (!GetVarint32(&input, &objective) ||
+      objective > static_cast<uint32_t>(TuningObjective::kLatency) ||
+      !GetFixed64(&input, &header->rate_limit_bytes_per_sec)) {
+    return Corrupted("header");
+  }
+  header->objective = static_cast<TuningObjective>(objective);
+  return Status::OK();
+}
+
+void EncodeTunerTraceRecord(const TunerTraceRecord& record,
+                            std::string* dst) {
+  PutInt(dst, record.secs_elapsed);
+  PutScores(dst, record.scores);
+  PutVarint32(dst, static_cast<uint32_t>(record.cf_states.size()));
+  for (const auto& cf : record.cf_states) {
+    PutColumnFamily(dst, cf);
+  }
+  PutInt(dst, record.flush_threads);
+  PutInt(dst, record.compaction_threads);
+  PutInt(dst, record.max_background_jobs);
+  PutFixed64(dst, record.write_buffer_size);
+  PutFixed64(dst, record.memtable_budget);
+  PutFixed64(dst, record.apply_micros);
+  PutFixed64(dst, record.rate_limit);
+  PutVarint32(dst, static_cast<uint32_t>(record.workload_phase));
+  PutCounters(dst, record.before);
+  PutCounters(dst, record.after);
+  PutVarint32(dst, record.decided ? 1 : 0);
+  PutTuningOp(dst, record.op);
+  PutVarint32(dst, static_cast<uint32_t>(record.change_points.size()));
+  for (const auto& point : record.change_points) {
+    PutLengthPrefixedSlice(dst, point.opt);
+    PutLengthPrefixedSlice(dst, point.value);
+    PutVarint32(dst, point.db_width ? 1 : 0);
+    PutFixed32(dst, point.cf_id);
+  }
+}
+
+Status DecodeTunerTraceRecord(Slice input, TunerTraceRecord* record) {
+  uint32_t num_cfs = 0;
+  if (!GetInt(&input, &record->secs_elapsed) ||
+      !GetScores(&input, &record->scores) ||
+      !GetVarint32(&input, &num_cfs)) {
+    return Corrupted("scores");
+  }
+  record->cf_states.resize(num_cfs);
+  for (auto& cf : record->cf_states) {
+    if (!GetColumnFamily(&input, &cf)) {
+      return Corrupted("column family");
+    }
+  }
+  uint32_t num_points = 0;
+  uint32_t phase = 0;
+  if (!GetInt(&input, &record->flush_threads) ||
+      !GetInt(&input, &record->compaction_threads) ||
+      !GetInt(&input, &record->max_background_jobs) ||
+      !GetFixed64(&input, &record->write_buffer_size) ||
+      !GetFixed64(&input, &record->memtable_budget) ||
+      !GetFixed64(&input, &record->apply_micros) ||
+      !GetFixed64(&input, &record->rate_limit) ||
+      !GetVarint32(&input, &phase) || phase > TuningWorkload::kMixed ||
+      !GetCounters(&input, &record->before) ||
+      !GetCounters(&input, &record->after) ||
+      !GetBool(&input, &record->decided) ||
+      !GetTuningOp(&input, &record->op) ||
+      !GetVarint32(&input, &num_points)) {
+    return Corrupted("decision");
+  }
+  record->workload_phase = static_cast<TuningWorkload::Phase>(phase);
+  record->change_points.resize(num_points);
+  for (auto& point : record->change_points) {
+    if (!GetString(&input, &point.opt) || !GetString(&input, &point.value) ||
+        !GetBool(&input, &point.db_width) ||
+        !GetFixed32(&input, &point.cf_id)) {
+      return Corrupted("change point");
+    }
+    point.change_timing = record->secs_elapsed;
+  }
+  return Status::OK();
+}
+
+Status TunerTraceWriter::Create(Env* env, const std::string& path,
+                                const TunerTraceHeader& header,
+                                std::unique_ptr<TunerTraceWriter>* writer) {
+  std::unique_ptr<WritableFile> file;
+  Status s = env->NewWritableFile(path, &file, EnvOptions());
+  if (!s.ok()) {
+    return s;
+  }
+  writer->reset(new TunerTraceWriter(std::move(file)));
+  std::string magic(kTunerTraceMagic, kTunerTraceMagicSize);
+  PutFixed32(&magic, kTraceVersion);
+  s = (*writer)->file_->Append(magic);
+  if (s.ok()) {
+    std::string encoded;
+    EncodeTunerTraceHeader(header, &encoded);
+    s = (*writer)->Append(encoded);
+  }
+  if (!s.ok()) {
+    writer->reset();
+  }
+  return s;
+}
+
+Status TunerTraceWriter::Write(const TunerTraceRecord& record) {
+  std::string encoded;
+  EncodeTunerTraceRecord(record, &encoded);
+  return Append(encoded);
+}
+
+Status TunerTraceWriter::Append(const std::string& encoded) {
+  buffer_.clear();
+  PutFixed32(&buffer_, static_cast<uint32_t>(encoded.size()));
+  buffer_.append(encoded);
+  Status s = file_->Append(buffer_);
+  if (s.ok()) {
+    s = file_->Flush();
+  }
+  return s;
+}
+
+Status TunerTraceReader::Open(Env* env, const std::string& path,
+                              std::unique_ptr<TunerTraceReader>* reader) {
+  std::unique_ptr<TunerTraceReader> r(new TunerTraceReader());
+  Status s = ReadFileToString(env, path, &r->data_);
+  if (!s.ok()) {
+    return s;
+  }
+  r->remaining_ = r->data_;
+  uint32_t version = 0;
+  if (!r->remaining_.starts_with(
+          Slice(kTunerTraceMagic, kTunerTraceMagicSize))) {
+    return Status::InvalidArgument(path, "not a tuner trace");
+  }
+  r->remaining_.remove_prefix(kTunerTraceMagicSize);
+  if (!GetFixed32(&r->remaining_, &version) || version != kTraceVersion) {
+    return Status::NotSupported("unknown tuner trace version");
+  }
+  Slice encoded;
+  s = r->Next(&encoded);
+  if (s.IsIncomplete()) {
+    return Corrupted("header");
+  }
+  if (s.ok()) {
+    s = DecodeTunerTraceHeader(encoded, &r->header_);
+  }
+  if (s.ok()) {
+    *reader = std::move(r);
+  }
+  return s;
+}
+
+Status TunerTraceReader::Read(TunerTraceRecord* record) {
+  Slice encoded;
+  Status s = Next(&encoded);
+  if (!s.ok()) {
+    return s;
+  }
+  *record = TunerTraceRecord();
+  return DecodeTunerTraceRecord(encoded, record);
+}
+
+Status TunerTraceReader::Next(Slice* encoded) {
+  if (remaining_.empty()) {
+    return Status::Incomplete("end of tuner trace");
+  }
+  uint32_t size = 0;
+  if (!GetFixed32(&remaining_, &size) || remaining_.size() < size) {
+    // the tuner stopped while writing the last record
+    remaining_.clear();
+    return Status::Incomplete("truncated tuner trace");
+  }
+  *encoded = Slice(remaining_.data(), size);
+  remaining_.remove_prefix(size);
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
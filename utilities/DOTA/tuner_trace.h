@@ -0,0 +1,146 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/db_impl/db_impl.h"
+#include "rocksdb/env.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "rocksdb/utilities/DOTA_tuner.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Binary trace of the tuner's decisions. Every tuning round is recorded with
+// everything the policy read (the system scores, the per column family scores
+// and options, the thread split and the memtable budget), the ARK counters
+// before and after the round and the change points it emitted. A trace can be
+// fed through any TuningPolicy offline with FEAT_Tuner::ReplayRound(), see
+// tools/tuner_replay.
+//
+// File format, all integers little endian:
+//   "ARKTRACE" fixed32(version) header records...
+// where every header and record is fixed32(length) followed by its encoding.
+
+// What the tuner was configured with, a replaying tuner is built from it.
+struct TunerTraceHeader {
+  std::string policy;
+  uint64_t tuning_gap = 1;
+  uint64_t core_number = 0;
+  uint64_t max_memtable_size = 0;
+  uint64_t write_buffer_size = 0;
+  uint64_t target_file_size_base = 0;
+  int max_background_jobs = 0;
+  int max_background_flushes = 0;
+  int max_background_compactions = 0;
+  TuningObjective objective = TuningObjective::kThroughput;
+  // of the DB's RateLimiter, 0 without one
+  uint64_t rate_limit_bytes_per_sec = 0;
+};
+
+struct TunerTraceRecord {
+  int secs_elapsed = 0;
+  // inputs of the round
+  SystemScores scores;
+  // scores and options of every column family, the ARK history is the one
+  // from before the round
+  std::vector<ColumnFamilyTuningState> cf_states;
+  int flush_threads = 0;
+  int compaction_threads = 0;
+  int max_background_jobs = 0;
+  uint64_t write_buffer_size = 0;
+  uint64_t memtable_budget = 0;
+  uint64_t apply_micros = 0;
+  uint64_t rate_limit = 0;
+  TuningWorkload::Phase workload_phase = TuningWorkload::kUnknown;
+  // ARK state around the round
+  ArkCounters before;
+  ArkCounters after;
+  // outputs, `decided` is false when the policy stopped after scoring
+  bool decided = false;
+  TuningOP op;
+  std::vector<ChangePoint> change_points;
+
+  // "ops(flush/comp/batch/sstable/thread/rate_limit/slots/merge/
+  // stall_limit/deep_compaction)=..." and the change points
+  std::string DecisionString() const;
+};
+
+// What the tuner learned and the operating point it reached, saved to
+// DBOptions::tuner_state_file so that a reopened DB resumes from it instead
+// of the defaults. It shares the encoding of the trace records, and a state
+// written with another version of either is refused with NotSupported:
+//   "ARKSTATE" fixed32(state version) fixed32(trace version)
+//   fixed32(masked crc32c of the rest) state
+struct TunerState {
+  SystemScores max_scores;
+  SystemScores avg_scores;
+  ArkCounters counters;
+  int max_thread = 0;
+  int flush_threads = 0;
+  int compaction_threads = 0;
+  uint64_t rate_limit = 0;
+  TuningWorkload::Phase workload_phase = TuningWorkload::kUnknown;
+  // options and ARK history of every column family, a reopened DB finds
+  // them by name
+  std::vector<ColumnFamilyTuningState> cf_states;
+};
+
+void EncodeTunerState(const TunerState& state, std::string* dst);
+Status DecodeTunerState(Slice input, TunerState* state);
+// The state goes to a temporary file that is synced and then renamed over
+// `path`, so a crash leaves either the old or the new state.
+Status WriteTunerState(Env* env, const std::string& path,
+                       const TunerState& state);
+Status ReadTunerState(Env* env, const std::string& path, TunerState* state);
+
+void EncodeTunerTraceHeader(const TunerTraceHeader& header, std::string* dst);
+Status DecodeTunerTraceHeader(Slice input, TunerTraceHeader* header);
+void EncodeTunerTraceRecord(const TunerTraceRecord& record, std::string* dst);
+Status DecodeTunerTraceRecord(Slice input, TunerTraceRecord* record);
+
+class TunerTraceWriter {
+ public:
+  static Status Create(Env* env, const std::string& path,
+                       const TunerTraceHeader& header,
+                       std::unique_ptr<TunerTraceWriter>* writer);
+
+  // Appends and flushes one record.
+  Status Write(const TunerTraceRecord& record);
+
+ private:
+  explicit TunerTraceWriter(std::unique_ptr<WritableFile>&& file)
+      : file_(std::move(file)) {}
+  Status Append(const std::string& encoded);
+
+  std::unique_ptr<WritableFile> file_;
+  std::string buffer_;
+};
+
+class TunerTraceReader {
+ public:
+  static Status Open(Env* env, const std::string& path,
+                     std::unique_ptr<TunerTraceReader>* reader);
+
+  const TunerTraceHeader& header() const { return header_; }
+
+  // Returns Status::Incomplete() after the last record.
+  Status Read(TunerTraceRecord* record);
+
+ private:
+  TunerTraceReader() = default;
+  Status Next(Slice* encoded);
+
+  std::string data_;
+  Slice remaining_;
+  TunerTraceHeader header_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,230 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "utilities/DOTA/tuner_trace.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "db/db_impl/db_impl.h"
+#include "test_util/testutil.h"
+#include "utilities/DOTA/tuner_test_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class TunerTraceTest : public TunerTestBase {
+ public:
+  TunerTraceTest() { trace_file_ = test::PerThreadDBPath("tuner_trace"); }
+  ~TunerTraceTest() override {
+    env_->DeleteFile(trace_file_).PermitUncheckedError();
+  }
+
+  std::string trace_file_;
+};
+
+TEST_F(TunerTraceTest, EncodeDecode) {
+  auto inputs = Inputs();
+  TunerTraceRecord record = inputs[5];
+  record.before.memtable_pressure_score = 2;
+  record.after.stall_suspect_counter = 1;
+  record.decided = true;
+  record.op =
+      TuningOP(kLinearIncrease, kKeep, kLinearIncrease, kHalf, kKeep, kHalf);
+  record.rate_limit = 32 << 20;
+  record.workload_phase = TuningWorkload::kScanHeavy;
+  ChangePoint point;
+  point.opt = "write_buffer_size";
+  point.value = "134217728";
+  point.change_timing = 0;
+  point.db_width = false;
+  point.cf_id = 3;
+  record.change_points.push_back(point);
+
+  std::string encoded;
+  EncodeTunerTraceRecord(record, &encoded);
+  TunerTraceRecord decoded;
+  ASSERT_OK(DecodeTunerTraceRecord(encoded, &decoded));
+  ASSERT_EQ(record.secs_elapsed, decoded.secs_elapsed);
+  ASSERT_EQ(record.scores.flush_speed_avg, decoded.scores.flush_speed_avg);
+  ASSERT_EQ(record.scores.immutable_number, decoded.scores.immutable_number);
+  ASSERT_EQ(1U, decoded.cf_states.size());
+  ASSERT_EQ("default", decoded.cf_states[0].name);
+  ASSERT_EQ(record.cf_states[0].l0_num, decoded.cf_states[0].l0_num);
+  ASSERT_TRUE(record.before == decoded.before);
+  ASSERT_TRUE(record.after == decoded.after);
+  ASSERT_EQ(record.DecisionString(), decoded.DecisionString());
+  ASSERT_EQ(record.rate_limit, decoded.rate_limit);
+  ASSERT_EQ(record.workload_phase, decoded.workload_phase);
+
+  // a cut record is corrupted
+  ASSERT_TRUE(DecodeTunerTraceRecord(Slice(encoded.data(), encoded.size() - 1),
+                                     &decoded)
+                  .IsCorruption());
+}
+
+TEST_F(TunerTraceTest, WriteAndRead) {
+  auto records = Replay(Inputs());
+  {
+    std::unique_ptr<TunerTraceWriter> writer;
+    ASSERT_OK(TunerTraceWriter::Create(env_, trace_file_, Header(), &writer));
+    for (const auto& record : records) {
+      ASSERT_OK(writer->Write(record));
+    }
+  }
+  std::unique_ptr<TunerTraceReader> reader;
+  ASSERT_OK(TunerTraceReader::Open(env_, trace_file_, &reader));
+  ASSERT_EQ("ARK", reader->header().policy);
+  ASSERT_EQ(8U, reader->header().core_number);
+  for (const auto& record : records) {
+    TunerTraceRecord read;
+    ASSERT_OK(reader->Read(&read));
+    ASSERT_EQ(record.secs_elapsed, read.secs_elapsed);
+    ASSERT_EQ(record.DecisionString(), read.DecisionString());
+  }
+  TunerTraceRecord read;
+  ASSERT_TRUE(reader->Read(&read).IsIncomplete());
+}
+
+TEST_F(TunerTraceTest, ReplayReproducesDecisions) {
+  auto traced = Replay(Inputs());
+  size_t decisions = 0;
+  size_t changes = 0;
+  for (const auto& record : traced) {
+    decisions += record.decided ? 1 : 0;
+    changes += record.change_points.size();
+  }
+  // the first round has no history to compare with
+  ASSERT_FALSE(traced[0].decided);
+  ASSERT_GT(decisions, 0U);
+  ASSERT_GT(changes, 0U);
+
+  // the recorded inputs lead a fresh tuner to the same decisions
+  auto replayed = Replay(traced);
+  ASSERT_EQ(traced.size(), replayed.size());
+  for (size_t i = 0; i < traced.size(); i++) {
+    ASSERT_EQ(traced[i].DecisionString(), replayed[i].DecisionString());
+    ASSERT_TRUE(traced[i].before == replayed[i].before);
+    ASSERT_TRUE(traced[i].after == replayed[i].after);
+  }
+}
+
+TEST_F(TunerTraceTest, SaveAndResumeState) {
+  auto tuner = NewTuner();
+  // nothing saved yet
+  ASSERT_OK(tuner->ResumeFrom(trace_file_));
+  for (const auto& input : Inputs()) {
+    TunerTraceRecord output;
+    tuner->ReplayRound(input, &output);
+  }
+  ASSERT_OK(tuner->SaveState());
+
+  TunerState saved;
+  ASSERT_OK(ReadTunerState(env_, trace_file_, &saved));
+  ASSERT_TRUE(tuner->GetArkCounters() == saved.counters);
+  ASSERT_EQ(1U, saved.cf_states.size());
+  ASSERT_EQ("default", saved.cf_states[0].name);
+
+  auto resumed = NewTuner();
+  ASSERT_OK(resumed->ResumeFrom(trace_file_));
+  ASSERT_TRUE(tuner->GetArkCounters() == resumed->GetArkCounters());
+  ASSERT_EQ(tuner->CurrentFlushThreads(), resumed->CurrentFlushThreads());
+  ASSERT_EQ(tuner->CurrentCompactionThreads(),
+            resumed->CurrentCompactionThreads());
+
+  // a torn or damaged file is refused, the tuner starts over
+  std::string data;
+  ASSERT_OK(ReadFileToString(env_, trace_file_, &data));
+  ASSERT_OK(WriteStringToFile(env_, data.substr(0, data.size() - 1),
+                              trace_file_));
+  ASSERT_TRUE(ReadTunerState(env_, trace_file_, &saved).IsCorruption());
+  data[data.size() - 1] ^= 1;
+  ASSERT_OK(WriteStringToFile(env_, data, trace_file_));
+  auto fresh = NewTuner();
+  ASSERT_TRUE(fresh->ResumeFrom(trace_file_).IsCorruption());
+  ASSERT_TRUE(fresh->GetArkCounters() == ArkCounters());
+}
+
+TEST_F(TunerTraceTest, RefuseOtherStateVersions) {
+  TunerState state;
+  state.flush_threads = 2;
+  ASSERT_OK(WriteTunerState(env_, trace_file_, state));
+  std::string data;
+  ASSERT_OK(ReadFileToString(env_, trace_file_, &data));
+  // the state version and then the trace version follow the magic
+  for (size_t offset : {8, 12}) {
+    std::string other = data;
+    other[offset] ^= 1;
+    ASSERT_OK(WriteStringToFile(env_, other, trace_file_));
+    TunerState read;
+    ASSERT_TRUE(ReadTunerState(env_, trace_file_, &read).IsNotSupported());
+  }
+  ASSERT_OK(WriteStringToFile(env_, data, trace_file_));
+  TunerState read;
+  ASSERT_OK(ReadTunerState(env_, trace_file_, &read));
+  ASSERT_EQ(2, read.flush_threads);
+}
+
+TEST_F(TunerTraceTest, ResumeFromLiveOptions) {
+  const std::string dbname = test::PerThreadDBPath("tuner_resume");
+  Options options;
+  options.create_if_missing = true;
+  options.write_buffer_size = 64 << 20;
+  options.max_write_buffer_number = 2;
+  options.db_write_buffer_size = 256 << 20;
+  // configured lower than when the state was saved
+  options.level0_slowdown_writes_trigger = 10;
+  options.level0_stop_writes_trigger = 30;
+  ASSERT_OK(DestroyDB(dbname, options));
+  DB* db = nullptr;
+  ASSERT_OK(DB::Open(options, dbname, &db));
+
+  // the tuner had doubled the stall limits and grown the memtables beyond
+  // what db_write_buffer_size now allows
+  TunerState state;
+  ColumnFamilyTuningState cf;
+  cf.name = kDefaultColumnFamilyName;
+  cf.write_buffer_size = 256 << 20;
+  cf.target_file_size_base = options.target_file_size_base;
+  cf.max_write_buffer_number = 4;
+  cf.min_write_buffer_number_to_merge = 1;
+  cf.base_level0_slowdown_writes_trigger = 20;
+  cf.base_level0_stop_writes_trigger = 36;
+  cf.level0_slowdown_writes_trigger = 40;
+  cf.level0_stop_writes_trigger = 72;
+  cf.compaction_relax_counter = 3;
+  state.cf_states.push_back(cf);
+  ASSERT_OK(WriteTunerState(env_, trace_file_, state));
+
+  int64_t last_report_ops = 0;
+  std::atomic<int64_t> total_ops{0};
+  FEAT_Tuner tuner(options, static_cast_with_check<DBImpl>(db->GetRootDB()),
+                   &last_report_ops, &total_ops, env_, 1, policy_);
+  ASSERT_OK(tuner.ResumeFrom(trace_file_));
+  std::vector<ChangePoint> changes;
+  tuner.DetectTuningOperations(1, &changes);
+  std::map<std::string, std::string> values;
+  for (const auto& point : changes) {
+    values[point.opt] = point.value;
+  }
+  // the memtables fit the budget and the stall limits are doubled over the
+  // configured ones
+  ASSERT_EQ(std::to_string(128 << 20), values["write_buffer_size"]);
+  ASSERT_EQ(0U, values.count("max_write_buffer_number"));
+  ASSERT_EQ("20", values["level0_slowdown_writes_trigger"]);
+  ASSERT_EQ("60", values["level0_stop_writes_trigger"]);
+  ASSERT_EQ(std::to_string(2 * options.soft_pending_compaction_bytes_limit),
+            values["soft_pending_compaction_bytes_limit"]);
+
+  delete db;
+  ASSERT_OK(DestroyDB(dbname, options));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
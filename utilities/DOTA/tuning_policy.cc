@@ -0,0 +1,164 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/tuning_policy.h"
+
+#include <mutex>
+
+#include "rocksdb/utilities/customizable_util.h"
+#include "rocksdb/utilities/object_registry.h"
+#include "rocksdb/utilities/report_agent.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+class ArkTuningPolicy : public TuningPolicy {
+ public:
+  static const char* kClassName() { return "ARK"; }
+  const char* Name() const override { return kClassName(); }
+  void DetectTuningOperations(
+      FEAT_Tuner* tuner, int /*secs_elapsed*/,
+      std::vector<ChangePoint>* change_list) const override {
+    if (tuner->ScoreRound()) {
+      tuner->FillUpChangeListArk(change_list, tuner->TuneByArk());
+    }
+  }
+};
+
+// TEA decides the background threads and FEA the memtable size, "FEAT" runs
+// both in the same round.
+class FEATTuningPolicy : public TuningPolicy {
+ public:
+  FEATTuningPolicy(bool tea_enable, bool fea_enable)
+      : tea_enable_(tea_enable), fea_enable_(fea_enable) {}
+  static const char* kClassName() { return "FEAT"; }
+  const char* Name() const override { return kClassName(); }
+  void DetectTuningOperations(
+      FEAT_Tuner* tuner, int /*secs_elapsed*/,
+      std::vector<ChangePoint>* change_list) const override {
+    if (!tuner->ScoreRound()) {
+      return;
+    }
+    TuningOP result{kKeep, kKeep};
+    if (tea_enable_) {
+      result = tuner->TuneByTEA();
+    }
+    if (fea_enable_) {
+      TuningOP fea_result = tuner->TuneByFEA();
+      result.BatchOp = fea_result.BatchOp;
+    }
+    tuner->FillUpChangeList(change_list, result);
+  }
+
+ private:
+  const bool tea_enable_;
+  const bool fea_enable_;
+};
+
+class TEATuningPolicy : public FEATTuningPolicy {
+ public:
+  TEATuningPolicy() : FEATTuningPolicy(true, false) {}
+  static const char* kClassName() { return "TEA"; }
+  const char* Name() const override { return kClassName(); }
+};
+
+class FEATuningPolicy : public FEATTuningPolicy {
+ public:
+  FEATuningPolicy() : FEATTuningPolicy(false, true) {}
+  static const char* kClassName() { return "FEA"; }
+  const char* Name() const override { return kClassName(); }
+};
+
+class DOTATuningPolicy : public TuningPolicy {
+ public:
+  static const char* kClassName() { return "DOTA"; }
+  const char* Name() const override { return kClassName(); }
+  void DetectTuningOperations(
+      FEAT_Tuner* tuner, int secs_elapsed,
+      std::vector<ChangePoint>* change_list) const override {
+    tuner->DOTA_Tuner::DetectTuningOperations(secs_elapsed, change_list);
+  }
+};
+
+#ifdef ROCKSDB_LITE
+bool LoadBuiltinTuningPolicy(const std::string& id,
+                             std::shared_ptr<TuningPolicy>* result) {
+  if (id == ArkTuningPolicy::kClassName()) {
+    result->reset(new ArkTuningPolicy());
+  } else if (id == FEATTuningPolicy::kClassName()) {
+    result->reset(new FEATTuningPolicy(true, true));
+  } else if (id == TEATuningPolicy::kClassName()) {
+    result->reset(new TEATuningPolicy());
+  } else if (id == FEATuningPolicy::kClassName()) {
+    result->reset(new FEATuningPolicy());
+  } else if (id == DOTATuningPolicy::kClassName()) {
+    result->reset(new DOTATuningPolicy());
+  } else {
+    return false;
+  }
+  return true;
+}
+#else
+template <typename T>
+void AddBuiltinTuningPolicy(ObjectLibrary& library) {
+  library.AddFactory<TuningPolicy>(
+      T::kClassName(),
+      [](const std::string& /*uri*/, std::unique_ptr<TuningPolicy>* guard,
+         std::string* /*errmsg*/) {
+        guard->reset(new T());
+        return guard->get();
+      });
+}
+
+static int RegisterBuiltinTuningPolicies(ObjectLibrary& library,
+                                         const std::string& /*arg*/) {
+  AddBuiltinTuningPolicy<ArkTuningPolicy>(library);
+  AddBuiltinTuningPolicy<TEATuningPolicy>(library);
+  AddBuiltinTuningPolicy<FEATuningPolicy>(library);
+  AddBuiltinTuningPolicy<DOTATuningPolicy>(library);
+  library.AddFactory<TuningPolicy>(
+      FEATTuningPolicy::kClassName(),
+      [](const std::string& /*uri*/, std::unique_ptr<TuningPolicy>* guard,
+         std::string* /*errmsg*/) {
+        guard->reset(new FEATTuningPolicy(true, true));
+        return guard->get();
+      });
+  size_t num_types;
+  return static_cast<int>(library.GetFactoryCount(&num_types));
+}
+#endif  // ROCKSDB_LITE
+}  // namespace
+
+Status TuningPolicy::CreateFromString(const ConfigOptions& config_options,
+                                      const std::string& value,
+                                      std::shared_ptr<TuningPolicy>* result) {
+#ifndef ROCKSDB_LITE
+  static std::once_flag once;
+  std::call_once(once, [&]() {
+    RegisterBuiltinTuningPolicies(*(ObjectLibrary::Default().get()), "");
+  });
+  return LoadSharedObject<TuningPolicy>(config_options, value, nullptr,
+                                        result);
+#else
+  return LoadSharedObject<TuningPolicy>(config_options, value,
+                                        LoadBuiltinTuningPolicy, result);
+#endif  // ROCKSDB_LITE
+}
+
+std::shared_ptr<TuningPolicy> TuningPolicy::FromFlags(bool tea_enable,
+                                                      bool fea_enable,
+                                                      bool ark_enable) {
+  if (ark_enable) {
+    return std::make_shared<ArkTuningPolicy>();
+  } else if (tea_enable && fea_enable) {
+    return std::make_shared<FEATTuningPolicy>(true, true);
+  } else if (tea_enable) {
+    return std::make_shared<TEATuningPolicy>();
+  } else if (fea_enable) {
+    return std::make_shared<FEATuningPolicy>();
+  }
+  return nullptr;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -135,6 +135,40 @@ void CoreWorkload::Init(const utils::Properties &p) {
     ordered_inserts_ = true;
   }
 
+  SetOperationMix(read_proportion, update_proportion, insert_proportion,
+                  scan_proportion, readmodifywrite_proportion);
+
+  insert_key_sequence_ = new CounterGenerator(insert_start);
+  transaction_insert_key_sequence_ =
+      new AcknowledgedCounterGenerator(record_count_);
+
+  operation_count_ = std::stoi(p.GetProperty(OPERATION_COUNT_PROPERTY));
+  request_dist_ = request_dist;
+  key_chooser_ = NewKeyChooser(request_dist, insert_proportion);
+  if (request_dist == "zipfian") {
+    std::cout << "insert start:" <<insert_start <<std::endl;
+    std::cout << "record count:" <<record_count_ <<std::endl;
+    std::cout << "op count:" <<operation_count_ <<std::endl;
+  }
+
+  field_chooser_ = new UniformGenerator(0, field_count_ - 1);
+
+  if (scan_len_dist == "uniform") {
+    scan_len_chooser_ = new UniformGenerator(min_scan_len, max_scan_len);
+  } else if (scan_len_dist == "zipfian") {
+    scan_len_chooser_ = new ZipfianGenerator(min_scan_len, max_scan_len);
+  } else {
+    throw utils::Exception("Distribution not allowed for scan length: " +
+                           scan_len_dist);
+  }
+}
+
+void CoreWorkload::SetOperationMix(double read_proportion,
+                                   double update_proportion,
+                                   double insert_proportion,
+                                   double scan_proportion,
+                                   double readmodifywrite_proportion) {
+  op_chooser_.Clear();
   if (read_proportion > 0) {
     op_chooser_.AddValue(READ, read_proportion);
   }
@@ -150,13 +184,12 @@ void CoreWorkload::Init(const utils::Properties &p) {
   if (readmodifywrite_proportion > 0) {
     op_chooser_.AddValue(READMODIFYWRITE, readmodifywrite_proportion);
   }
+}
 
-  insert_key_sequence_ = new CounterGenerator(insert_start);
-  transaction_insert_key_sequence_ =
-      new AcknowledgedCounterGenerator(record_count_);
-
+ycsbc::Generator<uint64_t> *CoreWorkload::NewKeyChooser(
+    const std::string &request_dist, double insert_proportion) {
   if (request_dist == "uniform") {
-    key_chooser_ = new UniformGenerator(0, record_count_ - 1);
+    return new UniformGenerator(0, record_count_ - 1);
 
   } else if (request_dist == "zipfian") {
     // If the number of keys changes, we don't want to change popular keys.
@@ -164,30 +197,30 @@ void CoreWorkload::Init(const utils::Properties &p) {
     // that is larger than what exists at the beginning of the test.
     // If the generator picks a key that is not inserted yet, we just ignore it
     // and pick another key.
-    int op_count = std::stoi(p.GetProperty(OPERATION_COUNT_PROPERTY));
-    int new_keys = (int)(op_count * insert_proportion * 2);  // a fudge factor
-    key_chooser_ = new ScrambledZipfianGenerator(record_count_ + new_keys);
-    std::cout << "insert start:" <<insert_start <<std::endl;
-    std::cout << "record count:" <<record_count_ <<std::endl;
-    std::cout << "op count:" <<op_count <<std::endl;
+    // a fudge factor
+    int new_keys = (int)(operation_count_ * insert_proportion * 2);
     std::cout << "new keys:" <<new_keys <<std::endl;
- 
+    return new ScrambledZipfianGenerator(record_count_ + new_keys);
+
   } else if (request_dist == "latest") {
-    key_chooser_ = new SkewedLatestGenerator(*transaction_insert_key_sequence_);
+    return new SkewedLatestGenerator(*transaction_insert_key_sequence_);
 
   } else {
     throw utils::Exception("Unknown request distribution: " + request_dist);
   }
+}
 
-  field_chooser_ = new UniformGenerator(0, field_count_ - 1);
-
-  if (scan_len_dist == "uniform") {
-    scan_len_chooser_ = new UniformGenerator(min_scan_len, max_scan_len);
-  } else if (scan_len_dist == "zipfian") {
-    scan_len_chooser_ = new ZipfianGenerator(min_scan_len, max_scan_len);
-  } else {
-    throw utils::Exception("Distribution not allowed for scan length: " +
-                           scan_len_dist);
+void CoreWorkload::SetPhase(const LoadPhase &phase) {
+  SetOperationMix(phase.read_proportion, phase.update_proportion,
+                  phase.insert_proportion, phase.scan_proportion,
+                  phase.readmodifywrite_proportion);
+  if (!phase.request_distribution.empty() &&
+      phase.request_distribution != request_dist_) {
+    Generator<uint64_t> *key_chooser =
+        NewKeyChooser(phase.request_distribution, phase.insert_proportion);
+    delete key_chooser_;
+    key_chooser_ = key_chooser;
+    request_dist_ = phase.request_distribution;
   }
 }
 
@@ -224,6 +257,19 @@ std::string CoreWorkload::BuildKeyName(uint64_t key_num) {
   return prekey.append(fill, '0').append(value);
 }
 
+std::string CoreWorkload::ScanUpperBound(uint64_t key_num, uint64_t len) {
+  if (ordered_inserts_) {
+    std::string bound = BuildKeyName(key_num + len);
+    if (bound.size() == BuildKeyName(key_num).size()) {
+      return bound;
+    }
+  }
+  // the successor of the "user" prefix
+  std::string bound = "user";
+  bound.back()++;
+  return bound;
+}
+
 void CoreWorkload::BuildValues(std::vector<ycsbc::DB::Field> &values) {
   for (int i = 0; i < field_count_; ++i) {
     values.push_back(DB::Field());
@@ -17,6 +17,7 @@
 #include "db.h"
 #include "discrete_generator.h"
 #include "generator.h"
+#include "load_profile.h"
 #include "properties.h"
 #include "utils.h"
 
@@ -163,6 +164,12 @@ class CoreWorkload {
   ///
   virtual void Init(const utils::Properties &p);
 
+  ///
+  /// Switch to the operation mix and key distribution of a load profile
+  /// phase, see load_profile.h. Not thread-safe, like the generators.
+  ///
+  void SetPhase(const LoadPhase &phase);
+
   virtual bool DoInsert(DB &db);
   virtual bool DoTransaction(DB &db);
 
@@ -180,7 +187,8 @@ class CoreWorkload {
         insert_key_sequence_(nullptr),
         transaction_insert_key_sequence_(nullptr),
         ordered_inserts_(true),
-        record_count_(0) {}
+        record_count_(0),
+        operation_count_(0) {}
 
   virtual ~CoreWorkload() {
     delete field_len_generator_;
@@ -194,6 +202,10 @@ class CoreWorkload {
   static Generator<uint64_t> *GetFieldLenGenerator(const utils::Properties &p);
   std::string BuildKeyName(uint64_t key_num);
   std::string BuildKeyName();
+  // An exclusive upper bound for a scan of `len` keys from key_num. Only
+  // ordered keys of the same width have one, otherwise every key is below
+  // the bound.
+  std::string ScanUpperBound(uint64_t key_num, uint64_t len);
   Operation NextOp();
   void BuildValues(std::vector<DB::Field> &values);
   void BuildSingleValue(std::vector<DB::Field> &update);
@@ -207,6 +219,12 @@ class CoreWorkload {
   int TransactionUpdate(DB &db);
   int TransactionInsert(DB &db);
 
+  void SetOperationMix(double read_proportion, double update_proportion,
+                       double insert_proportion, double scan_proportion,
+                       double readmodifywrite_proportion);
+  Generator<uint64_t> *NewKeyChooser(const std::string &request_dist,
+                                     double insert_proportion);
+
   std::string table_name_;
   int field_count_;
   std::string field_prefix_;
@@ -222,6 +240,8 @@ class CoreWorkload {
       *transaction_insert_key_sequence_;  // transaction insert key gen
   bool ordered_inserts_;
   size_t record_count_;
+  int operation_count_;
+  std::string request_dist_;
   int zero_padding_;
 };
 
@@ -23,6 +23,10 @@ class DiscreteGenerator : public Generator<Value> {
  public:
   DiscreteGenerator() : sum_(0) { }
   void AddValue(Value value, double weight);
+  void Clear() {
+    values_.clear();
+    sum_ = 0;
+  }
 
   Value Next();
   Value Last() { return last_; }
@@ -0,0 +1,116 @@
+//
+//  latency_histogram.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_LATENCY_HISTOGRAM_H_
+#define YCSB_C_LATENCY_HISTOGRAM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ycsbc {
+
+// Log-linear latency buckets, as in HdrHistogram: the values below
+// kSubBuckets get a bucket each, every power of two above is split into
+// kSubBuckets buckets of equal width. A percentile read from the buckets is
+// off by less than 1/kSubBuckets of the value. Values from 2^kMaxExponent on
+// share the last bucket.
+class LatencyBuckets {
+ public:
+  static constexpr int kSubBits = 4;
+  static constexpr uint64_t kSubBuckets = 1 << kSubBits;
+  static constexpr int kMaxExponent = 40;
+  static constexpr size_t kNumBuckets =
+      kSubBuckets + (kMaxExponent - kSubBits + 1) * kSubBuckets;
+
+  static size_t Index(uint64_t value) {
+    if (value < kSubBuckets) {
+      return static_cast<size_t>(value);
+    }
+    const int exponent = 63 - __builtin_clzll(value);
+    if (exponent > kMaxExponent) {
+      return kNumBuckets - 1;
+    }
+    const int shift = exponent - kSubBits;
+    return static_cast<size_t>(kSubBuckets +
+                               (exponent - kSubBits) * kSubBuckets +
+                               ((value >> shift) - kSubBuckets));
+  }
+
+  // the largest value of the bucket
+  static uint64_t UpperBound(size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    const int shift = static_cast<int>((index - kSubBuckets) / kSubBuckets);
+    const uint64_t sub = (index - kSubBuckets) % kSubBuckets;
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+  }
+};
+
+// The latencies of one operation, merged from the shards of a
+// Measurements. Not thread-safe.
+struct HistogramSnapshot {
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t min = std::numeric_limits<uint64_t>::max();
+  uint64_t max = 0;
+  std::vector<uint64_t> buckets =
+      std::vector<uint64_t>(LatencyBuckets::kNumBuckets, 0);
+
+  double Average() const {
+    return count > 0 ? static_cast<double>(sum) / count : 0.0;
+  }
+
+  // The latency below which `percentile` percent of the operations
+  // finished, 0 without any operation.
+  uint64_t Percentile(double percentile) const {
+    if (count == 0) {
+      return 0;
+    }
+    const double rank = percentile / 100.0 * count;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+      seen += buckets[i];
+      if (seen > 0 && seen >= rank) {
+        return std::min(LatencyBuckets::UpperBound(i), max);
+      }
+    }
+    return max;
+  }
+
+  void Merge(const HistogramSnapshot &other) {
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    for (size_t i = 0; i < buckets.size(); i++) {
+      buckets[i] += other.buckets[i];
+    }
+  }
+
+  // The operations since `earlier`, a snapshot of the same histogram. min
+  // and max can not be taken apart, they are read from the buckets.
+  HistogramSnapshot Since(const HistogramSnapshot &earlier) const {
+    HistogramSnapshot interval;
+    interval.count = count - earlier.count;
+    interval.sum = sum - earlier.sum;
+    for (size_t i = 0; i < buckets.size(); i++) {
+      interval.buckets[i] = buckets[i] - earlier.buckets[i];
+      if (interval.buckets[i] > 0) {
+        interval.min = std::min(interval.min, LatencyBuckets::UpperBound(i));
+        interval.max = LatencyBuckets::UpperBound(i);
+      }
+    }
+    interval.min = std::max(interval.min, min);
+    interval.max = std::min(interval.max, max);
+    return interval;
+  }
+};
+
+} // ycsbc
+
+#endif // YCSB_C_LATENCY_HISTOGRAM_H_
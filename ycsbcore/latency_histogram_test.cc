@@ -0,0 +1,169 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "ycsbcore/latency_histogram.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "test_util/testharness.h"
+#include "ycsbcore/measurements.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using ycsbc::HistogramSnapshot;
+using ycsbc::LatencyBuckets;
+
+class LatencyHistogramTest : public testing::Test {
+ public:
+  static HistogramSnapshot Snapshot(const std::vector<uint64_t>& values) {
+    HistogramSnapshot snapshot;
+    for (uint64_t value : values) {
+      snapshot.count++;
+      snapshot.sum += value;
+      snapshot.min = std::min(snapshot.min, value);
+      snapshot.max = std::max(snapshot.max, value);
+      snapshot.buckets[LatencyBuckets::Index(value)]++;
+    }
+    return snapshot;
+  }
+};
+
+TEST_F(LatencyHistogramTest, Buckets) {
+  // a bucket for every small value
+  for (uint64_t value = 0; value < LatencyBuckets::kSubBuckets; value++) {
+    ASSERT_EQ(value, LatencyBuckets::Index(value));
+    ASSERT_EQ(value, LatencyBuckets::UpperBound(value));
+  }
+  // every power of two opens a bucket, the value before it closes one
+  for (int exponent = LatencyBuckets::kSubBits;
+       exponent <= LatencyBuckets::kMaxExponent; exponent++) {
+    const uint64_t power = uint64_t{1} << exponent;
+    const size_t index = LatencyBuckets::Index(power);
+    ASSERT_EQ(index - 1, LatencyBuckets::Index(power - 1));
+    ASSERT_EQ(power - 1, LatencyBuckets::UpperBound(index - 1));
+    ASSERT_GE(LatencyBuckets::UpperBound(index), power);
+    ASSERT_LT(index, LatencyBuckets::kNumBuckets);
+  }
+  // every value falls below the upper bound of its bucket, and above the
+  // one of the bucket before
+  for (uint64_t value = 1; value < (uint64_t{1} << 20); value = value * 3 + 1) {
+    const size_t index = LatencyBuckets::Index(value);
+    ASSERT_LE(value, LatencyBuckets::UpperBound(index));
+    ASSERT_GT(value, LatencyBuckets::UpperBound(index - 1));
+  }
+  // beyond the buckets of 2^kMaxExponent all values share the top one
+  const size_t top = LatencyBuckets::kNumBuckets - 1;
+  ASSERT_EQ(top, LatencyBuckets::Index(
+                     (uint64_t{1} << (LatencyBuckets::kMaxExponent + 1)) - 1));
+  ASSERT_EQ(top, LatencyBuckets::Index(uint64_t{1}
+                                       << (LatencyBuckets::kMaxExponent + 1)));
+  ASSERT_EQ(top, LatencyBuckets::Index(UINT64_MAX));
+}
+
+TEST_F(LatencyHistogramTest, Percentiles) {
+  ASSERT_EQ(0U, HistogramSnapshot().Percentile(99));
+
+  std::vector<uint64_t> values;
+  for (uint64_t value = 1; value <= 100000; value++) {
+    values.push_back(value);
+  }
+  HistogramSnapshot snapshot = Snapshot(values);
+  ASSERT_EQ(100000U, snapshot.count);
+  ASSERT_DOUBLE_EQ(50000.5, snapshot.Average());
+  // off by less than 1/kSubBuckets of the value, and never below it
+  for (double percentile : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+    const double exact = percentile * 1000;
+    const uint64_t read = snapshot.Percentile(percentile);
+    ASSERT_GE(static_cast<double>(read), exact);
+    ASSERT_LE(static_cast<double>(read),
+              exact * (1 + 1.0 / LatencyBuckets::kSubBuckets));
+  }
+  // the largest value is not rounded up
+  ASSERT_EQ(100000U, snapshot.Percentile(100));
+
+  // a tail of one percent
+  values.assign(990, 10);
+  values.insert(values.end(), 10, 50000);
+  snapshot = Snapshot(values);
+  ASSERT_EQ(10U, snapshot.Percentile(50));
+  ASSERT_EQ(10U, snapshot.Percentile(99));
+  ASSERT_GE(snapshot.Percentile(99.9), 50000U);
+}
+
+TEST_F(LatencyHistogramTest, Since) {
+  std::vector<uint64_t> values(1000, 10);
+  HistogramSnapshot earlier = Snapshot(values);
+  values.insert(values.end(), 100, 5000);
+  HistogramSnapshot later = Snapshot(values);
+
+  // only the slow operations of the interval
+  HistogramSnapshot interval = later.Since(earlier);
+  ASSERT_EQ(100U, interval.count);
+  ASSERT_EQ(100U * 5000, interval.sum);
+  ASSERT_GE(interval.Percentile(50), 5000U);
+  ASSERT_GE(interval.min, 5000U);
+  ASSERT_EQ(5000U, interval.max);
+
+  // nothing in between
+  interval = later.Since(later);
+  ASSERT_EQ(0U, interval.count);
+  ASSERT_EQ(0U, interval.Percentile(99));
+
+  // merged snapshots add up
+  HistogramSnapshot merged = earlier;
+  merged.Merge(later.Since(earlier));
+  ASSERT_EQ(later.count, merged.count);
+  ASSERT_EQ(later.sum, merged.sum);
+  ASSERT_EQ(later.buckets, merged.buckets);
+}
+
+TEST_F(LatencyHistogramTest, Measurements) {
+  ycsbc::Measurements measurements;
+  // more threads than shards, some share one
+  const int kThreads = static_cast<int>(ycsbc::Measurements::kNumShards) + 4;
+  const int kReports = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&measurements, t]() {
+      for (int i = 0; i < kReports; i++) {
+        measurements.Report(ycsbc::READ, static_cast<uint64_t>(t + 1));
+      }
+      measurements.Report(ycsbc::UPDATE, 100);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // the shards are merged
+  HistogramSnapshot reads = measurements.Snapshot(ycsbc::READ);
+  ASSERT_EQ(static_cast<uint64_t>(kThreads * kReports), reads.count);
+  ASSERT_EQ(1U, reads.min);
+  ASSERT_EQ(static_cast<uint64_t>(kThreads), reads.max);
+  ASSERT_DOUBLE_EQ((kThreads + 1) / 2.0, measurements.GetLatency(ycsbc::READ));
+  uint64_t bucketed = 0;
+  for (uint64_t count : reads.buckets) {
+    bucketed += count;
+  }
+  ASSERT_EQ(reads.count, bucketed);
+  ASSERT_EQ(static_cast<uint64_t>(kThreads),
+            measurements.GetCount(ycsbc::UPDATE));
+  ASSERT_EQ(100U, measurements.Snapshot(ycsbc::UPDATE).Percentile(99));
+  ASSERT_EQ(0U, measurements.GetCount(ycsbc::INSERT));
+
+  measurements.Reset();
+  ASSERT_EQ(0U, measurements.GetCount(ycsbc::READ));
+  ASSERT_EQ(0U, measurements.Snapshot(ycsbc::READ).max);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
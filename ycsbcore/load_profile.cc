@@ -0,0 +1,128 @@
+//
+//  load_profile.cc
+//  YCSB-cpp
+//
+
+#include "load_profile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace {
+
+std::vector<std::string> SplitFields(const std::string &line) {
+  std::vector<std::string> fields;
+  std::istringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, ',')) {
+    fields.push_back(utils::Trim(field));
+  }
+  return fields;
+}
+
+double ParseNumber(const std::string &field, int line_no) {
+  size_t used = 0;
+  double value = 0.0;
+  try {
+    value = std::stod(field, &used);
+  } catch (const std::exception &) {
+    used = 0;
+  }
+  if (used == 0 || used != field.size() || value < 0 || std::isnan(value)) {
+    throw utils::Exception("Load profile line " + std::to_string(line_no) +
+                           ": bad number '" + field + "'");
+  }
+  return value;
+}
+
+} // namespace
+
+LoadProfile LoadProfile::FromFile(const std::string &path) {
+  std::ifstream input(path);
+  if (!input) {
+    throw utils::Exception("Can not read load profile " + path);
+  }
+  std::ostringstream csv;
+  csv << input.rdbuf();
+  return FromString(csv.str());
+}
+
+LoadProfile LoadProfile::FromString(const std::string &csv) {
+  LoadProfile profile;
+  std::istringstream input(csv);
+  std::string line;
+  int line_no = 0;
+  while (std::getline(input, line)) {
+    line_no++;
+    line = utils::Trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    if (profile.period_sec_ > 0) {
+      throw utils::Exception("Load profile line " + std::to_string(line_no) +
+                             ": nothing may follow repeat");
+    }
+    std::vector<std::string> fields = SplitFields(line);
+    if (fields[0] == "repeat") {
+      if (fields.size() != 2) {
+        throw utils::Exception("Load profile line " + std::to_string(line_no) +
+                               ": expected repeat,<secs>");
+      }
+      profile.period_sec_ = ParseNumber(fields[1], line_no);
+      if (profile.phases_.empty() ||
+          profile.period_sec_ <= profile.phases_.back().start_sec) {
+        throw utils::Exception("Load profile line " + std::to_string(line_no) +
+                               ": repeat must follow the last phase");
+      }
+      continue;
+    }
+    if (fields.size() != 7 && fields.size() != 8) {
+      throw utils::Exception("Load profile line " + std::to_string(line_no) +
+                             ": expected 7 or 8 fields");
+    }
+    LoadPhase phase;
+    phase.start_sec = ParseNumber(fields[0], line_no);
+    phase.ops_per_sec = ParseNumber(fields[1], line_no);
+    phase.read_proportion = ParseNumber(fields[2], line_no);
+    phase.update_proportion = ParseNumber(fields[3], line_no);
+    phase.insert_proportion = ParseNumber(fields[4], line_no);
+    phase.scan_proportion = ParseNumber(fields[5], line_no);
+    phase.readmodifywrite_proportion = ParseNumber(fields[6], line_no);
+    if (fields.size() == 8) {
+      phase.request_distribution = fields[7];
+    }
+    if (phase.read_proportion + phase.update_proportion +
+            phase.insert_proportion + phase.scan_proportion +
+            phase.readmodifywrite_proportion <= 0) {
+      throw utils::Exception("Load profile line " + std::to_string(line_no) +
+                             ": no operation");
+    }
+    if (profile.phases_.empty() ? phase.start_sec != 0
+                                : phase.start_sec <=
+                                      profile.phases_.back().start_sec) {
+      throw utils::Exception("Load profile line " + std::to_string(line_no) +
+                             ": phases must start at 0 and be in order");
+    }
+    profile.phases_.push_back(phase);
+  }
+  return profile;
+}
+
+size_t LoadProfile::PhaseAt(double secs) const {
+  if (period_sec_ > 0) {
+    secs = std::fmod(secs, period_sec_);
+  }
+  // the first phase that starts later, the phases start at 0
+  auto later = std::upper_bound(
+      phases_.begin(), phases_.end(), secs,
+      [](double t, const LoadPhase &phase) { return t < phase.start_sec; });
+  return later == phases_.begin() ? 0 : later - phases_.begin() - 1;
+}
+
+} // ycsbc
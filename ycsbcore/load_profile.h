@@ -0,0 +1,62 @@
+//
+//  load_profile.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_LOAD_PROFILE_H_
+#define YCSB_C_LOAD_PROFILE_H_
+
+#include <string>
+#include <vector>
+
+namespace ycsbc {
+
+///
+/// One phase of a load profile: from start_sec on, requests arrive at
+/// ops_per_sec with the given operation mix and key distribution.
+///
+struct LoadPhase {
+  double start_sec = 0.0;
+  // 0 issues the requests as fast as they return
+  double ops_per_sec = 0.0;
+  double read_proportion = 0.0;
+  double update_proportion = 0.0;
+  double insert_proportion = 0.0;
+  double scan_proportion = 0.0;
+  double readmodifywrite_proportion = 0.0;
+  // "uniform", "zipfian" or "latest", empty keeps the workload's
+  std::string request_distribution;
+};
+
+///
+/// A time-varying load, e.g. ingest by night and serving by day, read from
+/// a CSV file with one phase per line:
+///
+///   start_sec,ops_per_sec,read,update,insert,scan,readmodifywrite[,dist]
+///
+/// The phases are in the order of their start, the first one starts at 0.
+/// A last line "repeat,<secs>" starts the profile over every <secs> seconds,
+/// otherwise the last phase lasts until the end of the run. Empty lines and
+/// lines starting with '#' are skipped.
+///
+class LoadProfile {
+ public:
+  /// Throws utils::Exception if the file can not be read or parsed.
+  static LoadProfile FromFile(const std::string &path);
+  static LoadProfile FromString(const std::string &csv);
+
+  bool empty() const { return phases_.empty(); }
+  const std::vector<LoadPhase> &phases() const { return phases_; }
+  double period_sec() const { return period_sec_; }
+
+  /// The index of the phase `secs` seconds into the run.
+  size_t PhaseAt(double secs) const;
+
+ private:
+  std::vector<LoadPhase> phases_;
+  double period_sec_ = 0.0;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_LOAD_PROFILE_H_
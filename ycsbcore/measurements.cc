@@ -14,50 +14,123 @@
 
 namespace ycsbc {
 
-Measurements::Measurements() : count_{}, latency_sum_{}, latency_max_{} {
-  std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
+namespace {
+
+void AppendPercentiles(std::ostringstream &msg_stream,
+                       const HistogramSnapshot &histogram) {
+  msg_stream << " P50=" << histogram.Percentile(50) / 1000.0
+             << " P99=" << histogram.Percentile(99) / 1000.0
+             << " P99.9=" << histogram.Percentile(99.9) / 1000.0;
+}
+
+} // namespace
+
+Measurements::Measurements() : shards_(new Shard[kNumShards]), next_shard_(0) {
+  Reset();
+}
+
+Measurements::Shard &Measurements::ThreadShard() {
+  // a thread keeps its shard for every Measurements, there is one per run
+  thread_local size_t shard = std::numeric_limits<size_t>::max();
+  if (shard == std::numeric_limits<size_t>::max()) {
+    shard = next_shard_.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+  }
+  return shards_[shard];
 }
 
 void Measurements::Report(Operation op, uint64_t latency) {
-  count_[op].fetch_add(1, std::memory_order_relaxed);
-  latency_sum_[op].fetch_add(latency, std::memory_order_relaxed);
-  uint64_t prev_min = latency_min_[op].load(std::memory_order_relaxed);
+  // only shared by the threads beyond kNumShards
+  Shard &shard = ThreadShard();
+  shard.count[op].fetch_add(1, std::memory_order_relaxed);
+  shard.latency_sum[op].fetch_add(latency, std::memory_order_relaxed);
+  shard.buckets[op][LatencyBuckets::Index(latency)].fetch_add(
+      1, std::memory_order_relaxed);
+  uint64_t prev_min = shard.latency_min[op].load(std::memory_order_relaxed);
   while (prev_min > latency
-         && !latency_min_[op].compare_exchange_weak(prev_min, latency, std::memory_order_relaxed));
-  uint64_t prev_max = latency_max_[op].load(std::memory_order_relaxed);
+         && !shard.latency_min[op].compare_exchange_weak(prev_min, latency, std::memory_order_relaxed));
+  uint64_t prev_max = shard.latency_max[op].load(std::memory_order_relaxed);
   while (prev_max < latency
-         && !latency_max_[op].compare_exchange_weak(prev_max, latency, std::memory_order_relaxed));
+         && !shard.latency_max[op].compare_exchange_weak(prev_max, latency, std::memory_order_relaxed));
+}
+
+HistogramSnapshot Measurements::Snapshot(Operation op) {
+  HistogramSnapshot snapshot;
+  for (size_t i = 0; i < kNumShards; i++) {
+    const Shard &shard = shards_[i];
+    snapshot.count += shard.count[op].load(std::memory_order_relaxed);
+    snapshot.sum += shard.latency_sum[op].load(std::memory_order_relaxed);
+    snapshot.min = std::min(snapshot.min, shard.latency_min[op].load(std::memory_order_relaxed));
+    snapshot.max = std::max(snapshot.max, shard.latency_max[op].load(std::memory_order_relaxed));
+    for (size_t b = 0; b < LatencyBuckets::kNumBuckets; b++) {
+      snapshot.buckets[b] += shard.buckets[op][b].load(std::memory_order_relaxed);
+    }
+  }
+  return snapshot;
 }
 
 std::string Measurements::GetStatusMsg() {
+  std::lock_guard<std::mutex> lock(status_mutex_);
   std::ostringstream msg_stream;
   msg_stream.precision(2);
   uint64_t total_cnt = 0;
   msg_stream << std::fixed << " operations;";
   for (int i = 0; i < MAXOPTYPE; i++) {
     Operation op = static_cast<Operation>(i);
-    uint64_t cnt = GetCount(op);
+    HistogramSnapshot snapshot = Snapshot(op);
+    HistogramSnapshot interval = snapshot.Since(last_status_[op]);
+    last_status_[op] = snapshot;
+    uint64_t cnt = snapshot.count;
     if (cnt == 0)
       continue;
     msg_stream << " [" << kOperationString[op] << ":"
                << " Count=" << cnt
-               << " Max=" << latency_max_[op].load(std::memory_order_relaxed) / 1000.0
-               << " Min=" << latency_min_[op].load(std::memory_order_relaxed) / 1000.0
-               << " Avg="
-               << ((cnt > 0)
-                   ? static_cast<double>(latency_sum_[op].load(std::memory_order_relaxed)) / cnt
-                   : 0) / 1000.0
-               << "]";
+               << " Max=" << snapshot.max / 1000.0
+               << " Min=" << snapshot.min / 1000.0
+               << " Avg=" << snapshot.Average() / 1000.0;
+    AppendPercentiles(msg_stream, interval);
+    msg_stream << "]";
     total_cnt += cnt;
   }
   return std::to_string(total_cnt) + msg_stream.str();
 }
 
+std::string Measurements::GetSummaryMsg() {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed;
+  for (int i = 0; i < MAXOPTYPE; i++) {
+    Operation op = static_cast<Operation>(i);
+    HistogramSnapshot snapshot = Snapshot(op);
+    if (snapshot.count == 0)
+      continue;
+    msg_stream << "[" << kOperationString[op] << ":"
+               << " Count=" << snapshot.count
+               << " Max=" << snapshot.max / 1000.0
+               << " Min=" << snapshot.min / 1000.0
+               << " Avg=" << snapshot.Average() / 1000.0;
+    AppendPercentiles(msg_stream, snapshot);
+    msg_stream << "] ";
+  }
+  return msg_stream.str();
+}
+
 void Measurements::Reset() {
-  std::fill(std::begin(count_), std::end(count_), 0);
-  std::fill(std::begin(latency_sum_), std::end(latency_sum_), 0);
-  std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
-  std::fill(std::begin(latency_max_), std::end(latency_max_), 0);
+  for (size_t i = 0; i < kNumShards; i++) {
+    Shard &shard = shards_[i];
+    for (int op = 0; op < MAXOPTYPE; op++) {
+      shard.count[op].store(0, std::memory_order_relaxed);
+      shard.latency_sum[op].store(0, std::memory_order_relaxed);
+      shard.latency_min[op].store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+      shard.latency_max[op].store(0, std::memory_order_relaxed);
+      for (size_t b = 0; b < LatencyBuckets::kNumBuckets; b++) {
+        shard.buckets[op][b].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(status_mutex_);
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    last_status_[op] = HistogramSnapshot();
+  }
 }
 
 } // ycsbc
@@ -9,31 +9,51 @@
 #define YCSB_C_MEASUREMENTS_H_
 
 #include "core_workload.h"
+#include "latency_histogram.h"
 
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
 
 namespace ycsbc {
 
+// Every client thread reports into a shard of its own, so the threads never
+// share a cache line. The readers merge the shards.
 class Measurements {
  public:
+  static constexpr size_t kNumShards = 64;
+
   Measurements();
   void Report(Operation op, uint64_t latency);
   uint64_t GetCount(Operation op) {
-    return count_[op].load(std::memory_order_relaxed);
+    return Snapshot(op).count;
   }
   double GetLatency(Operation op) {
-    uint64_t cnt = GetCount(op);
-    return cnt > 0
-        ? static_cast<double>(latency_sum_[op].load(std::memory_order_relaxed)) / cnt
-        : 0.0;
+    return Snapshot(op).Average();
   }
+  HistogramSnapshot Snapshot(Operation op);
+  // Count, min, max and average of the whole run, and the percentiles of
+  // the operations since the previous status message.
   std::string GetStatusMsg();
+  // Everything of the whole run, percentiles included.
+  std::string GetSummaryMsg();
   void Reset();
  private:
-  std::atomic<uint> count_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_sum_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_min_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_max_[MAXOPTYPE];
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> count[MAXOPTYPE];
+    std::atomic<uint64_t> latency_sum[MAXOPTYPE];
+    std::atomic<uint64_t> latency_min[MAXOPTYPE];
+    std::atomic<uint64_t> latency_max[MAXOPTYPE];
+    std::atomic<uint64_t> buckets[MAXOPTYPE][LatencyBuckets::kNumBuckets];
+  };
+  Shard &ThreadShard();
+
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<size_t> next_shard_;
+  // the snapshots of the previous status message
+  std::mutex status_mutex_;
+  HistogramSnapshot last_status_[MAXOPTYPE];
 };
 
 } // ycsbc
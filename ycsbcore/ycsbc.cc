@@ -123,6 +123,8 @@ int ycsbc_main(const int argc, const char *argv[]) {
     std::cout << "Load runtime(sec): " << runtime << std::endl;
     std::cout << "Load operations(ops): " << sum << std::endl;
     std::cout << "Load throughput(ops/sec): " << sum / runtime << std::endl;
+    std::cout << "Load latency(us): " << measurements.GetSummaryMsg()
+              << std::endl;
   }
 
   measurements.Reset();
@@ -169,6 +171,8 @@ int ycsbc_main(const int argc, const char *argv[]) {
     std::cout << "Run runtime(sec): " << runtime << std::endl;
     std::cout << "Run operations(ops): " << sum << std::endl;
     std::cout << "Run throughput(ops/sec): " << sum / runtime << std::endl;
+    std::cout << "Run latency(us): " << measurements.GetSummaryMsg()
+              << std::endl;
   }
 
   for (int i = 0; i < num_threads; i++) {